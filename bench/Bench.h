@@ -0,0 +1,31 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * Bench.h
+ *
+ *  Created on: Oct 2026
+ *      Author: Gregor Weiss
+ *
+ *  Shared pieces of the micro-benchmarks, which run on a single rank.
+ */
+
+#ifndef BENCH_H_
+#define BENCH_H_
+
+#include "Settings.h"
+
+#include <string>
+#include <vector>
+
+// directory the backends write to, dir= on the command line
+const std::string& benchDirectory();
+
+// settings of a single rank with an n^3 local array and the given scheme,
+// options as on the heatTransfer command line
+Settings benchSettings( const std::string& scheme,
+                        unsigned int n,
+                        unsigned int iterations,
+                        const std::vector<std::string>& options = {} );
+
+#endif /* BENCH_H_ */
@@ -0,0 +1,112 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * BenchBackends.cpp
+ *
+ *  Created on: Oct 2026
+ *      Author: Gregor Weiss
+ *
+ *  Write and read of every scheme on a single rank. shmstage needs a
+ *  consumer and is left out, ascii cannot be read back.
+ */
+
+#include "Bench.h"
+#include "Generator.h"
+#include "HeatTransfer.h"
+#include "IO.h"
+
+#include <exception>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <mpi.h>
+
+namespace {
+
+constexpr unsigned int iterations = 4;
+
+void setCounters( benchmark::State& state, const Settings& s ) {
+  if ( s.format == "mdtest" ) {
+    state.SetItemsProcessed( static_cast<int64_t>( state.iterations() ) * s.files );
+  } else {
+    state.SetBytesProcessed( static_cast<int64_t>( state.iterations() * s.localGB * 1e9 ) );
+  }
+}
+
+void write( benchmark::State& state, const std::string& scheme ) {
+  const auto n = static_cast<unsigned int>( state.range( 0 ) );
+  Settings s = benchSettings( scheme, n, iterations, { "data=heat" } );
+  HeatTransfer ht( s );
+  generate( s, 1, ht.m_TIterations );
+  IO<IOVariant> io( s, MPI_COMM_WORLD );
+  io.chooseFormat( s.format );
+
+  int step = 0;
+  for ( auto _ : state ) {
+    io.write( ++step, ht, s, MPI_COMM_WORLD );
+    state.PauseTiming();
+    io.remove( step );
+    state.ResumeTiming();
+  }
+  setCounters( state, s );
+}
+
+void read( benchmark::State& state, const std::string& scheme ) {
+  const auto n = static_cast<unsigned int>( state.range( 0 ) );
+  Settings s = benchSettings( scheme, n, iterations, { "data=heat" } );
+  HeatTransfer ht( s );
+  generate( s, 1, ht.m_TIterations );
+  IO<IOVariant> io( s, MPI_COMM_WORLD );
+  io.chooseFormat( s.format );
+  io.write( 1, ht, s, MPI_COMM_WORLD );
+
+  std::vector<std::vector<double> > buffer( iterations, std::vector<double>( static_cast<size_t>( n ) * n * n ) );
+  for ( auto _ : state ) {
+    IO<IOVariant> reader( s, MPI_COMM_WORLD );
+    reader.chooseFormat( s.format );
+    reader.read( 1, buffer, s, MPI_COMM_WORLD );
+  }
+  io.remove( 1 );
+  setCounters( state, s );
+}
+
+// a scheme failing, e.g. without its library, is reported instead of ending the run
+void BM_Write( benchmark::State& state, const std::string& scheme ) {
+  try {
+    write( state, scheme );
+  } catch ( std::exception& e ) {
+    state.SkipWithError( e.what() );
+  }
+}
+
+void BM_Read( benchmark::State& state, const std::string& scheme ) {
+  try {
+    read( state, scheme );
+  } catch ( std::exception& e ) {
+    state.SkipWithError( e.what() );
+  }
+}
+
+const std::vector<std::string> readable{
+  "adios2", "binary", "binary_with_folders", "mdtest", "stream", "level0", "level1",
+  "level3_1Dsubarray", "level3_2Dsubarray", "level3_2Dsubarray_contiguous",
+  "level3_1Ddarray", "level3_2Ddarray", "level3_2Ddarray_contiguous",
+#ifdef HAVE_SIONLIB
+  "sion",
+#endif
+};
+
+// registered before main runs, like the BENCHMARK macros
+[[maybe_unused]] const bool registered = []()
+{
+  for ( const auto& scheme : readable ) {
+    benchmark::RegisterBenchmark( ( "BM_Write/" + scheme ).c_str(), BM_Write, scheme )->Arg( 64 )->Arg( 128 );
+    benchmark::RegisterBenchmark( ( "BM_Read/" + scheme ).c_str(), BM_Read, scheme )->Arg( 64 )->Arg( 128 );
+  }
+  benchmark::RegisterBenchmark( "BM_Write/ascii", BM_Write, std::string( "ascii" ) )->Arg( 64 );
+  return true;
+}();
+
+} // namespace
@@ -0,0 +1,102 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * BenchKernels.cpp
+ *
+ *  Created on: Oct 2026
+ *      Author: Gregor Weiss
+ *
+ *  Stencil, halo packing, snapshot copy and the synthetic data generator.
+ */
+
+#include "Bench.h"
+#include "Generator.h"
+#include "HeatTransfer.h"
+
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <mpi.h>
+
+namespace {
+
+double localBytes( unsigned int n ) {
+  return static_cast<double>( n ) * n * n * sizeof( double );
+}
+
+void BM_Iterate( benchmark::State& state ) {
+  const auto n = static_cast<unsigned int>( state.range( 0 ) );
+  Settings s = benchSettings( "binary", n, 1 );
+  HeatTransfer ht( s );
+  ht.init( false );
+  for ( auto _ : state ) {
+    ht.iterate();
+  }
+  state.SetBytesProcessed( static_cast<int64_t>( state.iterations() * localBytes( n ) ) );
+  state.SetItemsProcessed( static_cast<int64_t>( state.iterations() ) * n * n * n );
+}
+BENCHMARK( BM_Iterate )->RangeMultiplier( 2 )->Range( 32, 256 )->Unit( benchmark::kMillisecond );
+
+// the ghost layers as HeatTransfer::exchange sends them: 0 y faces, 1 x faces, 2 z faces
+void BM_Halo( benchmark::State& state ) {
+  const auto n = static_cast<int>( state.range( 0 ) );
+  const int face = static_cast<int>( state.range( 1 ) );
+  MPI_Datatype type;
+  if ( face == 0 ) {
+    MPI_Type_vector( n + 2, n + 2, ( n + 2 ) * ( n + 2 ), MPI_REAL8, &type );
+  } else if ( face == 1 ) {
+    MPI_Type_vector( n + 2, n + 2, n + 2, MPI_REAL8, &type );
+  } else {
+    MPI_Type_vector( ( n + 2 ) * ( n + 2 ), 1, n + 2, MPI_REAL8, &type );
+  }
+  MPI_Type_commit( &type );
+
+  std::vector<double> field( static_cast<size_t>( n + 2 ) * ( n + 2 ) * ( n + 2 ), 1.0 );
+  int packed = 0;
+  MPI_Pack_size( 1, type, MPI_COMM_SELF, &packed );
+  std::vector<char> buffer( static_cast<size_t>( packed ) );
+  for ( auto _ : state ) {
+    int position = 0;
+    MPI_Pack( field.data(), 1, type, buffer.data(), packed, &position, MPI_COMM_SELF );
+    position = 0;
+    MPI_Unpack( buffer.data(), packed, &position, field.data(), 1, type, MPI_COMM_SELF );
+    benchmark::ClobberMemory();
+  }
+  MPI_Type_free( &type );
+  // packed and unpacked
+  state.SetBytesProcessed( static_cast<int64_t>( state.iterations() ) * 2 * packed );
+}
+BENCHMARK( BM_Halo )->ArgsProduct( { { 64, 256 }, { 0, 1, 2 } } );
+
+// data_noghost and the copy into m_TIterations
+void BM_Snapshot( benchmark::State& state ) {
+  const auto n = static_cast<unsigned int>( state.range( 0 ) );
+  Settings s = benchSettings( "binary", n, 1 );
+  HeatTransfer ht( s );
+  ht.init( false );
+  for ( auto _ : state ) {
+    ht.m_TIterations.clear();
+    ht.store();
+    benchmark::DoNotOptimize( ht.m_TIterations.back().data() );
+  }
+  state.SetBytesProcessed( static_cast<int64_t>( state.iterations() * localBytes( n ) ) );
+}
+BENCHMARK( BM_Snapshot )->RangeMultiplier( 2 )->Range( 32, 256 );
+
+void BM_Generate( benchmark::State& state, const std::string& pattern ) {
+  const auto n = static_cast<unsigned int>( state.range( 0 ) );
+  Settings s = benchSettings( "binary", n, 1, { "data=" + pattern } );
+  std::vector<std::vector<double> > iterations;
+  unsigned int step = 0;
+  for ( auto _ : state ) {
+    generate( s, ++step, iterations );
+    benchmark::DoNotOptimize( iterations.front().data() );
+  }
+  state.SetBytesProcessed( static_cast<int64_t>( state.iterations() * localBytes( n ) ) );
+}
+BENCHMARK_CAPTURE( BM_Generate, ramp, std::string( "ramp" ) )->Arg( 128 );
+BENCHMARK_CAPTURE( BM_Generate, heat, std::string( "heat" ) )->Arg( 128 );
+BENCHMARK_CAPTURE( BM_Generate, random, std::string( "random" ) )->Arg( 128 );
+
+} // namespace
@@ -0,0 +1,86 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * main.cpp
+ *
+ * Micro-benchmarks of the kernels and backends of heatTransfer on a single
+ * rank, e.g.
+ *   heatTransfer_bench dir=/dev/shm --benchmark_filter=Write
+ *
+ *  Created on: Oct 2026
+ *      Author: Gregor Weiss
+ *
+ */
+#include <mpi.h>
+
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include <benchmark/benchmark.h>
+
+#include "Bench.h"
+
+namespace {
+
+std::string directory;
+
+} // namespace
+
+const std::string& benchDirectory() {
+  return directory;
+}
+
+Settings benchSettings( const std::string& scheme,
+                        unsigned int n,
+                        unsigned int iterations,
+                        const std::vector<std::string>& options ) {
+  const std::string size = std::to_string( n );
+  std::vector<std::string> arguments{ "heatTransfer_bench", "none",
+                                      ( std::filesystem::path( directory ) / "bench" ).string(), scheme,
+                                      "1", "1", "1", size, size, size, "1", std::to_string( iterations ) };
+  arguments.insert( arguments.end(), options.begin(), options.end() );
+  std::vector<char*> argv;
+  for ( auto& argument : arguments ) {
+    argv.push_back( argument.data() );
+  }
+  Settings s( static_cast<int>( argv.size() ), argv.data(), 0, 1 );
+  // ADIOS2 without a config file
+  s.configfile = "";
+  return s;
+}
+
+int main( int argc, char* argv[] ) {
+  MPI_Init( &argc, &argv );
+
+  int nproc;
+  MPI_Comm_size( MPI_COMM_WORLD, &nproc );
+  if ( nproc != 1 ) {
+    std::cout << "heatTransfer_bench runs on a single rank\n";
+    MPI_Finalize();
+    return 1;
+  }
+
+  benchmark::Initialize( &argc, argv );
+  // default: tmpfs if there is one
+  directory = std::filesystem::is_directory( "/dev/shm" ) ? "/dev/shm" : ".";
+  for ( int i = 1; i < argc; ++i ) {
+    std::string_view option{ argv[i] };
+    if ( option.starts_with( "dir=" ) ) {
+      directory = option.substr( 4 );
+    } else {
+      std::cout << "Unknown option " << option << "\n"
+                << "Usage: heatTransfer_bench [dir=<directory>] [--benchmark_...]\n";
+      MPI_Finalize();
+      return 1;
+    }
+  }
+
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+
+  MPI_Finalize();
+  return 0;
+}
@@ -0,0 +1,31 @@
+# FindLZ4.cmake
+#
+# - Find LZ4 header and library
+#
+# This module defines
+#  LZ4_FOUND, if false, do not try to use LZ4.
+#  LZ4_INCLUDE, where to find lz4.h.
+#  LZ4_LIBRARIES, the libraries to link against to use LZ4.
+#
+# As a hint allows LZ4_ROOT_DIR.
+
+find_path( LZ4_INCLUDE
+    NAMES lz4.h
+    HINTS ${LZ4_ROOT_DIR}/include
+    )
+
+find_library( LZ4_LIBRARIES
+    NAMES lz4
+    HINTS ${LZ4_ROOT_DIR}/lib ${LZ4_ROOT_DIR}/lib64
+    )
+
+include( FindPackageHandleStandardArgs )
+find_package_handle_standard_args( LZ4
+  FOUND_VAR
+    LZ4_FOUND
+  REQUIRED_VARS
+    LZ4_LIBRARIES
+    LZ4_INCLUDE
+    )
+
+mark_as_advanced( LZ4_ROOT_DIR LZ4_INCLUDE LZ4_LIBRARIES )
@@ -0,0 +1,31 @@
+# FindZFP.cmake
+#
+# - Find ZFP header and library
+#
+# This module defines
+#  ZFP_FOUND, if false, do not try to use ZFP.
+#  ZFP_INCLUDE, where to find zfp.h.
+#  ZFP_LIBRARIES, the libraries to link against to use ZFP.
+#
+# As a hint allows ZFP_ROOT_DIR.
+
+find_path( ZFP_INCLUDE
+    NAMES zfp.h
+    HINTS ${ZFP_ROOT_DIR}/include
+    )
+
+find_library( ZFP_LIBRARIES
+    NAMES zfp
+    HINTS ${ZFP_ROOT_DIR}/lib ${ZFP_ROOT_DIR}/lib64
+    )
+
+include( FindPackageHandleStandardArgs )
+find_package_handle_standard_args( ZFP
+  FOUND_VAR
+    ZFP_FOUND
+  REQUIRED_VARS
+    ZFP_LIBRARIES
+    ZFP_INCLUDE
+    )
+
+mark_as_advanced( ZFP_ROOT_DIR ZFP_INCLUDE ZFP_LIBRARIES )
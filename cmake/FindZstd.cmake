@@ -0,0 +1,31 @@
+# FindZstd.cmake
+#
+# - Find Zstandard header and library
+#
+# This module defines
+#  ZSTD_FOUND, if false, do not try to use Zstandard.
+#  ZSTD_INCLUDE, where to find zstd.h.
+#  ZSTD_LIBRARIES, the libraries to link against to use Zstandard.
+#
+# As a hint allows ZSTD_ROOT_DIR.
+
+find_path( ZSTD_INCLUDE
+    NAMES zstd.h
+    HINTS ${ZSTD_ROOT_DIR}/include
+    )
+
+find_library( ZSTD_LIBRARIES
+    NAMES zstd
+    HINTS ${ZSTD_ROOT_DIR}/lib ${ZSTD_ROOT_DIR}/lib64
+    )
+
+include( FindPackageHandleStandardArgs )
+find_package_handle_standard_args( Zstd
+  FOUND_VAR
+    ZSTD_FOUND
+  REQUIRED_VARS
+    ZSTD_LIBRARIES
+    ZSTD_INCLUDE
+    )
+
+mark_as_advanced( ZSTD_ROOT_DIR ZSTD_INCLUDE ZSTD_LIBRARIES )
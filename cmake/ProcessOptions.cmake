@@ -18,3 +18,62 @@ function(PROCESS_WITH_SIONLIB)
         endif ()
     endif ()
 endfunction()
+
+function(PROCESS_WITH_LZ4)
+    set(HAVE_LZ4 OFF)
+    if (with-lz4)
+        if (NOT ${with-lz4} STREQUAL "ON")
+            set(LZ4_ROOT_DIR "${with-lz4}" CACHE INTERNAL "lz4")
+        endif ()
+
+        find_package(LZ4)
+        include_directories(${LZ4_INCLUDE})
+
+        if (LZ4_FOUND)
+            set(HAVE_LZ4 ON CACHE INTERNAL "lz4")
+            add_definitions( -DHAVE_LZ4 )
+        endif ()
+    endif ()
+endfunction()
+
+function(PROCESS_WITH_ZSTD)
+    set(HAVE_ZSTD OFF)
+    if (with-zstd)
+        if (NOT ${with-zstd} STREQUAL "ON")
+            set(ZSTD_ROOT_DIR "${with-zstd}" CACHE INTERNAL "zstd")
+        endif ()
+
+        find_package(Zstd)
+        include_directories(${ZSTD_INCLUDE})
+
+        if (ZSTD_FOUND)
+            set(HAVE_ZSTD ON CACHE INTERNAL "zstd")
+            add_definitions( -DHAVE_ZSTD )
+        endif ()
+    endif ()
+endfunction()
+
+function(PROCESS_WITH_INSTRUMENTATION)
+    set(HAVE_INSTRUMENTATION OFF)
+    if (with-instrumentation)
+        set(HAVE_INSTRUMENTATION ON CACHE INTERNAL "instrumentation")
+        add_definitions( -DHAVE_INSTRUMENTATION )
+    endif ()
+endfunction()
+
+function(PROCESS_WITH_ZFP)
+    set(HAVE_ZFP OFF)
+    if (with-zfp)
+        if (NOT ${with-zfp} STREQUAL "ON")
+            set(ZFP_ROOT_DIR "${with-zfp}" CACHE INTERNAL "zfp")
+        endif ()
+
+        find_package(ZFP)
+        include_directories(${ZFP_INCLUDE})
+
+        if (ZFP_FOUND)
+            set(HAVE_ZFP ON CACHE INTERNAL "zfp")
+            add_definitions( -DHAVE_ZFP )
+        endif ()
+    endif ()
+endfunction()
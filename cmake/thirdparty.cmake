@@ -41,3 +41,24 @@ if(NOT ${ADIOS2_FOUND})
 else()
   message(STATUS "Found ADIOS2 ${ADIOS2_CHECKOUT_VERSION}")
 endif()
+
+# Google Benchmark of the micro-benchmarks, -Dwith-benchmarks=ON
+if(with-benchmarks)
+  find_package(benchmark QUIET)
+  if(NOT ${benchmark_FOUND})
+    cpmaddpackage(
+      NAME
+      benchmark
+      GITHUB_REPOSITORY
+      google/benchmark
+      VERSION
+      1.8.3
+      OPTIONS
+      "BENCHMARK_ENABLE_TESTING OFF"
+      "BENCHMARK_ENABLE_GTEST_TESTS OFF"
+      "BENCHMARK_ENABLE_INSTALL OFF"
+      SYSTEM)
+  else()
+    message(STATUS "Found Google Benchmark ${benchmark_VERSION}")
+  endif()
+endif()
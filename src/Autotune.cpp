@@ -0,0 +1,173 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * Autotune.cpp
+ *
+ *  Created on: Oct 2026
+ *      Author: Gregor Weiss
+ */
+
+#include "Autotune.h"
+#include "Hints.h"
+#include "helper.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+// an empty list keeps the value of the arguments
+template<typename T>
+std::vector<T> orDefault( const std::vector<T>& list, const T& value ) {
+  return list.empty() ? std::vector<T>{ value } : list;
+}
+
+bool isMPIIO( const std::string& scheme ) {
+  return scheme.find( "level" ) != std::string::npos;
+}
+
+} // namespace
+
+Autotuner::Autotuner( const Settings& s, MPI_Comm comm )
+  : _settings{ s }
+  , _communicator{ comm }
+  , _rank{ getRank( comm ) } {
+  // hints only matter to MPI-IO and parameters only to ADIOS2, the other
+  // schemes get a single candidate each
+  for ( const auto& scheme : orDefault( s.tuneSchemes, s.format ) ) {
+    const bool mpiio = isMPIIO( scheme );
+    const bool adios2 = scheme == "adios2";
+    const auto hints = mpiio ? orDefault( s.tuneHints, s.hints ) : std::vector<Hints>{ s.hints };
+    const auto parameters = adios2 ? orDefault( s.tuneParameters, s.parameters ) : std::vector<Hints>{ s.parameters };
+    const auto aggregators = mpiio || adios2 ? orDefault( s.tuneAggregators, 0u ) : std::vector<unsigned int>{ 0 };
+    const auto chunks = mpiio || adios2 ? orDefault( s.tuneChunks, 0u ) : std::vector<unsigned int>{ 0 };
+    for ( const auto& hintSet : hints ) {
+      for ( const auto& parameterSet : parameters ) {
+        for ( auto aggregator : aggregators ) {
+          for ( auto chunk : chunks ) {
+            Settings c = s;
+            c.format = scheme;
+            c.hints = hintSet;
+            c.parameters = parameterSet;
+            if ( aggregator > 0 ) {
+              setHint( mpiio ? c.hints : c.parameters, mpiio ? "cb_nodes" : "NumAggregators", std::to_string( aggregator ) );
+            }
+            if ( chunk > 0 ) {
+              setHint( mpiio ? c.hints : c.parameters, mpiio ? "cb_buffer_size" : "BufferChunkSize", std::to_string( chunk ) );
+            }
+            _candidates.push_back( { c, 0.0 } );
+          }
+        }
+      }
+    }
+  }
+  for ( size_t i = 0; i < _candidates.size(); ++i ) {
+    _survivors.push_back( i );
+  }
+
+  if ( !s.tuneCache.empty() ) {
+    load();
+  }
+}
+
+void Autotuner::measure( int step, const Trial& trial ) {
+  const unsigned int repeats = 1u << _rung;
+  for ( auto i : _survivors ) {
+    auto& candidate = _candidates[i];
+    double sum = 0.0;
+    for ( unsigned int r = 0; r < repeats; ++r ) {
+      const double seconds = trial( candidate.settings );
+      // the same on all ranks, so that all drop the same candidates
+      double maxSeconds = 0.0;
+      MPI_Allreduce( &seconds, &maxSeconds, 1, MPI_DOUBLE, MPI_MAX, _communicator );
+      sum += maxSeconds;
+    }
+    candidate.seconds = sum / repeats;
+    if ( _rank == 0 ) {
+      std::cout << "Autotuning step " << step
+                << " " << describe( candidate.settings )
+                << " max. time [s] " << candidate.seconds
+                << " perf [GB/s] " << _settings.globalGB / candidate.seconds << "\n";
+    }
+  }
+
+  std::stable_sort( _survivors.begin(), _survivors.end(),
+                    [ this ]( size_t a, size_t b ) { return _candidates[a].seconds < _candidates[b].seconds; } );
+  _survivors.resize( ( _survivors.size() + 1 ) / 2 );
+  ++_rung;
+
+  if ( !tuning() && _rank == 0 ) {
+    std::cout << "Autotuner chose " << describe() << "\n";
+    if ( !_settings.tuneCache.empty() ) {
+      store();
+    }
+  }
+}
+
+std::string Autotuner::describe( const Settings& s ) {
+  return "scheme " + s.format + " hints " + toString( s.hints ) + " parameters " + toString( s.parameters );
+}
+
+std::string Autotuner::key() const {
+  const unsigned long long bytes = static_cast<unsigned long long>( _settings.ndx ) * _settings.ndy * _settings.ndz
+                                 * sizeof( double ) * _settings.iterations;
+  return std::to_string( _settings.nproc ) + " " + std::to_string( bytes );
+}
+
+void Autotuner::load() {
+  // cache lines: nproc bytes scheme hints parameters
+  int cached = -1;
+  if ( _rank == 0 ) {
+    std::ifstream cache( _settings.tuneCache );
+    std::string line;
+    while ( std::getline( cache, line ) ) {
+      std::istringstream fields( line );
+      std::string nproc, bytes, scheme, hints, parameters;
+      if ( !( fields >> nproc >> bytes >> scheme >> hints >> parameters ) || nproc + " " + bytes != key() ) {
+        continue;
+      }
+      for ( size_t i = 0; i < _candidates.size(); ++i ) {
+        const auto& c = _candidates[i].settings;
+        if ( c.format == scheme && toString( c.hints ) == hints && toString( c.parameters ) == parameters ) {
+          cached = static_cast<int>( i );
+        }
+      }
+    }
+  }
+  MPI_Bcast( &cached, 1, MPI_INT, 0, _communicator );
+  if ( cached < 0 ) {
+    return;
+  }
+  _survivors.assign( 1, static_cast<size_t>( cached ) );
+  if ( _rank == 0 ) {
+    std::cout << "Autotuner cached " << describe() << "\n";
+  }
+}
+
+void Autotuner::store() const {
+  std::vector<std::string> lines;
+  {
+    std::ifstream cache( _settings.tuneCache );
+    std::string line;
+    while ( std::getline( cache, line ) ) {
+      std::istringstream fields( line );
+      std::string nproc, bytes;
+      if ( fields >> nproc >> bytes && nproc + " " + bytes != key() ) {
+        lines.push_back( line );
+      }
+    }
+  }
+  const auto& c = choice();
+  lines.push_back( key() + " " + c.format + " " + toString( c.hints ) + " " + toString( c.parameters ) );
+
+  std::ofstream cache( _settings.tuneCache, std::ios_base::out | std::ios_base::trunc );
+  for ( const auto& line : lines ) {
+    cache << line << "\n";
+  }
+  if ( !cache ) {
+    std::cout << "WARNING: cannot write the autotuner cache " << _settings.tuneCache << "\n";
+  }
+}
@@ -0,0 +1,74 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * Autotune.h
+ *
+ *  Created on: Oct 2026
+ *      Author: Gregor Weiss
+ *
+ *  Online choice of the scheme and its transfer parameters: the first steps
+ *  are written with every candidate, the slower half is dropped after every
+ *  step (successive halving) and the survivors are measured twice as often
+ *  on the next one, until one is left. The choice is kept in a cache file
+ *  keyed by the number of processes and the bytes per rank and step.
+ */
+
+#ifndef AUTOTUNE_H_
+#define AUTOTUNE_H_
+
+#include "Settings.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+#include <mpi.h>
+
+class Autotuner
+{
+ public:
+  // writes a step with the candidate settings and removes it again, collective,
+  // returns the seconds this rank spent writing
+  using Trial = std::function<double( const Settings& candidate )>;
+
+  // builds the candidates from the tune. options and looks up the cache, collective
+  Autotuner( const Settings& s, MPI_Comm comm );
+
+  // more than one candidate left
+  bool tuning() const { return _survivors.size() > 1; }
+
+  // measures the surviving candidates on step and drops the slower half,
+  // stores the choice in the cache once one is left, collective
+  void measure( int step, const Trial& trial );
+
+  // the fastest candidate so far
+  const Settings& choice() const { return _candidates[_survivors.front()].settings; }
+
+  // scheme, hints and parameters of the choice
+  std::string describe() const { return describe( choice() ); }
+
+ private:
+  struct Candidate
+  {
+    Settings settings;
+    double seconds{ 0.0 }; // average max. time of the ranks in the last rung
+  };
+
+  static std::string describe( const Settings& s );
+
+  std::string key() const;
+
+  // rank 0 looks up the cache and broadcasts the cached candidate if it is one of these
+  void load();
+
+  void store() const;
+
+  const Settings& _settings;
+  MPI_Comm _communicator;
+  int _rank;
+  std::vector<Candidate> _candidates{};
+  std::vector<size_t> _survivors{}; // fastest first after a rung
+  unsigned int _rung{ 0 };
+};
+
+#endif /* AUTOTUNE_H_ */
@@ -0,0 +1,233 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * BurstBuffer.cpp
+ *
+ *  Created on: Oct 2026
+ *      Author: Gregor Weiss
+ */
+
+#include "BurstBuffer.h"
+#include "helper.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+
+BurstBuffer::BurstBuffer( const Settings& s, MPI_Comm comm, Drain drain )
+  : _settings{ s }
+  , _comm{ comm }
+  , _drain{ std::move( drain ) }
+  , _rank{ getRank( comm ) } {
+  std::error_code ec;
+  std::filesystem::create_directories( _settings.stage, ec );
+  if ( !std::filesystem::is_directory( _settings.stage ) ) {
+    throw std::runtime_error("BurstBuffer: cannot create the staging directory " + _settings.stage);
+  }
+
+  // the drain calls MPI concurrently with the solver
+  int provided;
+  MPI_Query_thread( &provided );
+  _threaded = ( provided == MPI_THREAD_MULTIPLE );
+  if ( _threaded ) {
+    _thread = std::thread( &BurstBuffer::run, this );
+  } else if ( _rank == 0 ) {
+    std::cout << "WARNING: MPI_THREAD_MULTIPLE is not available, a step is drained when the next one is staged\n";
+  }
+}
+
+BurstBuffer::~BurstBuffer() {
+  if ( _threaded ) {
+    {
+      std::lock_guard<std::mutex> lock( _mutex );
+      _stopping = true;
+    }
+    _changed.notify_all();
+    _thread.join();
+  } else {
+    try {
+      drainUntil( std::numeric_limits<int>::max() );
+    } catch ( std::exception& e ) {
+      std::cout << "BurstBuffer: " << e.what() << std::endl;
+    }
+  }
+  for ( const auto& pending : _queue ) {
+    std::filesystem::remove( pending.filename );
+  }
+}
+
+void BurstBuffer::stage( int step, const HeatTransfer& ht, MPI_Comm comm ) {
+  const double begin = MPI_Wtime();
+  const auto bytes = static_cast<std::uintmax_t>( _settings.ndx ) * _settings.ndy * _settings.ndz
+                   * sizeof( double ) * ht.m_TIterations.size();
+  TraceScope scope( "stage", "io", bytes, step );
+
+  if ( !_threaded ) {
+    drainUntil( std::numeric_limits<int>::max() );
+  }
+
+  // capacity: a bounded number of steps and the space left on the staging directory
+  std::unique_lock<std::mutex> lock( _mutex );
+  _changed.wait( lock,
+    [ this, bytes ]()
+    {
+      if ( _error ) {
+        return true;
+      }
+      if ( _queue.empty() ) {
+        return true;
+      }
+      std::error_code ec;
+      auto space = std::filesystem::space( _settings.stage, ec );
+      return _queue.size() < _settings.stageSteps && ( ec || space.available >= bytes );
+    } );
+  if ( _error ) {
+    std::rethrow_exception( _error );
+  }
+  const size_t queued = _queue.size();
+  lock.unlock();
+  const double capacityWait = MPI_Wtime() - begin;
+
+  const std::string filename = MakeFilename( ( std::filesystem::path( _settings.stage )
+                                               / std::filesystem::path( _settings.outputfile ).filename() ).string(),
+                                             ".stage", _settings.rank, step );
+  std::ofstream out( filename, std::ios_base::out | std::ios_base::binary );
+  const auto write_size = static_cast<std::streamsize>( bytes / std::max<size_t>( ht.m_TIterations.size(), 1 ) );
+  for ( const auto& iteration : ht.m_TIterations ) {
+    out.write( reinterpret_cast<const char*>( iteration.data() ), write_size );
+  }
+  out.close();
+  if ( !out ) {
+    throw std::runtime_error("BurstBuffer: cannot write " + filename);
+  }
+
+  std::error_code ec;
+  const double available = static_cast<double>( std::filesystem::space( _settings.stage, ec ).available );
+  {
+    std::lock_guard<std::mutex> guard( _mutex );
+    _queue.push_back( { step, filename, begin, MPI_Wtime() } );
+  }
+  _changed.notify_all();
+
+  double maxWait = 0.0, minAvailable = 0.0;
+  unsigned long long localQueued = queued + 1, maxQueued = 0;
+  MPI_Reduce( &capacityWait, &maxWait, 1, MPI_DOUBLE, MPI_MAX, 0, comm );
+  MPI_Reduce( &available, &minAvailable, 1, MPI_DOUBLE, MPI_MIN, 0, comm );
+  MPI_Reduce( &localQueued, &maxQueued, 1, MPI_UNSIGNED_LONG_LONG, MPI_MAX, 0, comm );
+  if ( _rank == 0 ) {
+    printDrained();
+    std::cout << "Staging step " << step
+              << " staged steps " << maxQueued
+              << " max. capacity wait [s] " << maxWait
+              << " min. free [GB] " << minAvailable * 1e-9 << "\n";
+  }
+}
+
+void BurstBuffer::wait( int step ) {
+  if ( _threaded ) {
+    std::unique_lock<std::mutex> lock( _mutex );
+    _changed.wait( lock, [ this, step ]() { return _persisted >= step || _error; } );
+    if ( _error ) {
+      std::rethrow_exception( _error );
+    }
+  } else {
+    drainUntil( step );
+  }
+  if ( _rank == 0 ) {
+    printDrained();
+  }
+}
+
+double BurstBuffer::heldBytes() const {
+  return _heldBytes.load();
+}
+
+void BurstBuffer::run() {
+  trace::threadName( "drain" );
+  for ( ;; ) {
+    std::unique_lock<std::mutex> lock( _mutex );
+    _changed.wait( lock, [ this ]() { return _stopping || !_queue.empty(); } );
+    if ( _queue.empty() ) {
+      return;
+    }
+    Pending pending = _queue.front();
+    lock.unlock();
+
+    try {
+      drainOne( pending );
+    } catch ( ... ) {
+      lock.lock();
+      _error = std::current_exception();
+      _changed.notify_all();
+      return;
+    }
+
+    lock.lock();
+    _queue.pop_front();
+    _persisted = pending.step;
+    lock.unlock();
+    _changed.notify_all();
+  }
+}
+
+void BurstBuffer::drainUntil( int step ) {
+  while ( !_queue.empty() && _persisted < step ) {
+    drainOne( _queue.front() );
+    _persisted = _queue.front().step;
+    _queue.pop_front();
+  }
+}
+
+void BurstBuffer::drainOne( const Pending& pending ) {
+  const double begin = MPI_Wtime();
+
+  const size_t count = static_cast<size_t>( _settings.ndx ) * _settings.ndy * _settings.ndz;
+  TraceScope scope( "drain", "io", count * sizeof( double ) * _settings.iterations, pending.step );
+  // the buffers are kept from step to step
+  _iterations.resize( _settings.iterations );
+  for ( auto& iteration : _iterations ) {
+    iteration.resize( count );
+  }
+  _heldBytes = static_cast<double>( _iterations.size() * count * sizeof( double ) );
+  std::ifstream in( pending.filename, std::ios_base::in | std::ios_base::binary );
+  for ( auto& iteration : _iterations ) {
+    in.read( reinterpret_cast<char*>( iteration.data() ),
+             static_cast<std::streamsize>( count * sizeof( double ) ) );
+  }
+  if ( !in ) {
+    throw std::runtime_error("BurstBuffer: cannot read " + pending.filename);
+  }
+  in.close();
+
+  _drain( pending.step, _iterations );
+  std::filesystem::remove( pending.filename );
+
+  const double end = MPI_Wtime();
+  double local[3] = { begin - pending.staged, end - begin, end - pending.begin };
+  double global[3];
+  MPI_Reduce( local, global, 3, MPI_DOUBLE, MPI_MAX, 0, _comm );
+  if ( _rank == 0 ) {
+    std::lock_guard<std::mutex> lock( _mutex );
+    _drained.push_back( { pending.step, global[0], global[1], global[2] } );
+  }
+}
+
+void BurstBuffer::printDrained() {
+  std::vector<Drained> drained;
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+    drained.swap( _drained );
+  }
+  for ( const auto& d : drained ) {
+    std::cout << "Draining step " << d.step
+              << " max. lag [s] " << d.lag
+              << " max. drain time [s] " << d.drainTime
+              << " perf [GB/s] " << _settings.globalGB / d.drainTime
+              << " max. persistence time [s] " << d.persistence << "\n";
+  }
+}
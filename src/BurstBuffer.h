@@ -0,0 +1,103 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * BurstBuffer.h
+ *
+ *  Created on: Oct 2026
+ *      Author: Gregor Weiss
+ *
+ *  Write-behind tier in front of any scheme: a step is written to a
+ *  node-local staging directory and the caller continues. A drain thread
+ *  reads the staged step back and writes it with the chosen scheme to the
+ *  final target, step by step in the order they were staged.
+ */
+
+#ifndef BURSTBUFFER_H_
+#define BURSTBUFFER_H_
+
+#include "HeatTransfer.h"
+#include "Settings.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <mpi.h>
+
+class BurstBuffer
+{
+ public:
+  // writes a staged step to the final target, collective on the drain communicator
+  using Drain = std::function<void( int step, const std::vector<std::vector<double> >& iterations )>;
+
+  // comm is used by the drain only and must not be used by anyone else concurrently
+  BurstBuffer( const Settings& s, MPI_Comm comm, Drain drain );
+
+  // drains the remaining steps, collective
+  ~BurstBuffer();
+
+  BurstBuffer( BurstBuffer const& other ) = delete;
+
+  BurstBuffer& operator=( BurstBuffer const& other ) = delete;
+
+  // writes the iterations to the staging directory and queues the step,
+  // blocks while stageSteps steps are not drained yet or the directory is full
+  void stage( int step, const HeatTransfer& ht, MPI_Comm comm );
+
+  // blocks until step is in the final target
+  void wait( int step );
+
+  // bytes of the iterations buffer of the drain
+  double heldBytes() const;
+
+ private:
+  struct Pending
+  {
+    int step;
+    std::string filename;
+    double begin;  // stage called
+    double staged; // stage returned
+  };
+
+  struct Drained
+  {
+    int step;
+    double lag;         // from staged until the drain started
+    double drainTime;
+    double persistence; // from stage called until drained
+  };
+
+  void run();
+
+  void drainOne( const Pending& pending );
+
+  void drainUntil( int step );
+
+  // rank 0 prints the steps drained since the last call
+  void printDrained();
+
+  const Settings _settings;
+  std::vector<std::vector<double> > _iterations{}; // of the step being drained
+  MPI_Comm _comm;
+  Drain _drain;
+  int _rank;
+  bool _threaded;
+
+  std::mutex _mutex;
+  std::condition_variable _changed;
+  std::deque<Pending> _queue{};
+  int _persisted{ 0 };
+  bool _stopping{ false };
+  std::exception_ptr _error{};
+  std::vector<Drained> _drained{};
+  std::thread _thread{};
+  std::atomic<double> _heldBytes{ 0.0 }; // of _iterations, set by the drain
+};
+
+#endif /* BURSTBUFFER_H_ */
@@ -0,0 +1,251 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * Calibration.cpp
+ *
+ *  Created on: Oct 2026
+ *      Author: Gregor Weiss
+ */
+
+#include "Calibration.h"
+#include "helper.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr int repeats = 5;       // memory and network, the best one counts
+constexpr int deviceRepeats = 2;
+constexpr std::size_t alignment = 4096;
+constexpr std::size_t blockBytes = std::size_t( 4 ) << 20;
+
+struct Aligned
+{
+  void operator()( char* p ) const { std::free( p ); }
+};
+
+using Block = std::unique_ptr<char, Aligned>;
+
+Block alignedBlock() {
+  void* p = nullptr;
+  if ( posix_memalign( &p, alignment, blockBytes ) != 0 ) {
+    throw std::bad_alloc();
+  }
+  std::memset( p, 1, blockBytes );
+  return Block( static_cast<char*>( p ) );
+}
+
+// rethrows on every rank if fn failed on any, so that no rank is left in a collective
+template<typename Fn>
+void collectively( Fn&& fn, MPI_Comm comm ) {
+  std::string error;
+  try {
+    fn();
+  } catch ( std::exception& e ) {
+    error = e.what();
+  }
+  int failed = error.empty() ? 0 : 1;
+  int anyFailed = 0;
+  MPI_Allreduce( &failed, &anyFailed, 1, MPI_INT, MPI_MAX, comm );
+  if ( anyFailed != 0 ) {
+    throw std::runtime_error( failed != 0 ? error : "calibrate: failed on another rank" );
+  }
+}
+
+// the least max. time over the ranks of a few repeats, fn returns the seconds
+template<typename Fn>
+double bestTime( Fn&& fn, MPI_Comm comm, int count = repeats ) {
+  double best = 0.0;
+  for ( int r = 0; r < count; ++r ) {
+    MPI_Barrier( comm );
+    double seconds = 0.0;
+    collectively( [ & ]() { seconds = fn(); }, comm );
+    double slowest = 0.0;
+    MPI_Allreduce( &seconds, &slowest, 1, MPI_DOUBLE, MPI_MAX, comm );
+    best = ( r == 0 ) ? slowest : std::min( best, slowest );
+  }
+  return best;
+}
+
+template<typename Fn>
+double timed( Fn&& fn ) {
+  double seconds = MPI_Wtime();
+  fn();
+  return MPI_Wtime() - seconds;
+}
+
+double copyRate( std::size_t bytes, MPI_Comm comm ) {
+  const std::size_t count = bytes / sizeof( double );
+  std::vector<double> a( count, 1.0 ), b( count, 0.0 );
+  double seconds = bestTime(
+    [ & ]() { return timed( [ & ]() { std::memcpy( b.data(), a.data(), count * sizeof( double ) ); } ); }, comm );
+  return 2.0 * static_cast<double>( count * sizeof( double ) ) * getNProcs( comm ) / seconds * 1e-9;
+}
+
+double alltoallRate( std::size_t bytes, MPI_Comm comm ) {
+  const int nprocs = getNProcs( comm );
+  const int perPeer = static_cast<int>( std::max<std::size_t>( bytes / nprocs, 1 ) );
+  std::vector<char> send( static_cast<std::size_t>( perPeer ) * nprocs, 1 ), receive( send.size() );
+  double seconds = bestTime(
+    [ & ]()
+    {
+      return timed( [ & ]() { MPI_Alltoall( send.data(), perPeer, MPI_BYTE, receive.data(), perPeer, MPI_BYTE, comm ); } );
+    }, comm );
+  return static_cast<double>( perPeer ) * ( nprocs - 1 ) * nprocs / seconds * 1e-9;
+}
+
+double neighbourRate( std::size_t bytes, MPI_Comm comm ) {
+  const int rank = getRank( comm );
+  const int nprocs = getNProcs( comm );
+  std::vector<char> send( bytes, 1 ), receive( bytes );
+  double seconds = bestTime(
+    [ & ]()
+    {
+      return timed(
+        [ & ]()
+        {
+          MPI_Sendrecv( send.data(), static_cast<int>( bytes ), MPI_BYTE, ( rank + 1 ) % nprocs, 0,
+                        receive.data(), static_cast<int>( bytes ), MPI_BYTE, ( rank + nprocs - 1 ) % nprocs, 0,
+                        comm, MPI_STATUS_IGNORE );
+        } );
+    }, comm );
+  return static_cast<double>( bytes ) * nprocs / seconds * 1e-9;
+}
+
+// seconds to write or read blocks of a file, O_DIRECT if direct
+double writeFile( const std::string& filename, std::size_t blocks, const char* block, bool& direct ) {
+  int fd = ::open( filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC | ( direct ? O_DIRECT : 0 ), 0644 );
+  if ( fd < 0 && direct && errno == EINVAL ) {
+    direct = false;
+    fd = ::open( filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+  }
+  if ( fd < 0 ) {
+    throw std::runtime_error( "calibrate: cannot write " + filename );
+  }
+  double seconds = MPI_Wtime();
+  for ( std::size_t b = 0; b < blocks; ++b ) {
+    if ( ::write( fd, block, blockBytes ) != static_cast<ssize_t>( blockBytes ) ) {
+      ::close( fd );
+      throw std::runtime_error( "calibrate: cannot write " + filename );
+    }
+  }
+  fdatasync( fd );
+  seconds = MPI_Wtime() - seconds;
+  ::close( fd );
+  return seconds;
+}
+
+double readFile( const std::string& filename, std::size_t blocks, char* block, bool direct ) {
+  int fd = ::open( filename.c_str(), O_RDONLY | ( direct ? O_DIRECT : 0 ) );
+  if ( fd < 0 ) {
+    throw std::runtime_error( "calibrate: cannot read " + filename );
+  }
+  double seconds = MPI_Wtime();
+  for ( std::size_t b = 0; b < blocks; ++b ) {
+    if ( ::read( fd, block, blockBytes ) != static_cast<ssize_t>( blockBytes ) ) {
+      ::close( fd );
+      throw std::runtime_error( "calibrate: cannot read " + filename );
+    }
+  }
+  seconds = MPI_Wtime() - seconds;
+  ::close( fd );
+  return seconds;
+}
+
+void printRate( const char* name, double rate ) {
+  std::cout << " " << name << " ";
+  if ( rate > 0.0 ) {
+    std::cout << rate;
+  } else {
+    std::cout << "n/a";
+  }
+}
+
+} // namespace
+
+Ceilings calibrate( const Settings& s, MPI_Comm comm ) {
+  const int rank = getRank( comm );
+  const int nprocs = getNProcs( comm );
+  Ceilings c;
+
+  // the step of a rank, within 16 MiB and 1 GiB, in whole blocks
+  const double stepBytes = s.localGB * 1e9;
+  const std::size_t bytes = std::clamp<std::size_t>( static_cast<std::size_t>( stepBytes ), std::size_t( 16 ) << 20,
+                                                     std::size_t( 1 ) << 30 ) / blockBytes * blockBytes;
+  const std::size_t blocks = bytes / blockBytes;
+
+  c.copy = copyRate( bytes, comm );
+  if ( nprocs > 1 ) {
+    c.alltoall = alltoallRate( std::min<std::size_t>( bytes, std::size_t( 64 ) << 20 ), comm );
+    c.neighbour = neighbourRate( std::min<std::size_t>( bytes, std::size_t( 64 ) << 20 ), comm );
+  }
+
+  // every rank agrees on O_DIRECT with the first write of rank 0
+  Block block = alignedBlock();
+  const std::string filename = MakeFilename( s.outputfile, ".calibrate", rank );
+  int direct = 1;
+  collectively(
+    [ & ]()
+    {
+      if ( rank == 0 ) {
+        bool d = true;
+        double seconds = writeFile( filename, blocks, block.get(), d );
+        direct = d ? 1 : 0;
+        seconds = std::min( seconds, writeFile( filename, blocks, block.get(), d ) );
+        c.sequentialWrite = static_cast<double>( bytes ) / seconds * 1e-9;
+        if ( !d ) {
+          EvictFromCache( filename );
+        }
+        c.sequentialRead = static_cast<double>( bytes ) / readFile( filename, blocks, block.get(), d ) * 1e-9;
+      }
+    }, comm );
+  MPI_Bcast( &direct, 1, MPI_INT, 0, comm );
+  MPI_Bcast( &c.sequentialWrite, 1, MPI_DOUBLE, 0, comm );
+  MPI_Bcast( &c.sequentialRead, 1, MPI_DOUBLE, 0, comm );
+
+  // the file system of a rank may still refuse O_DIRECT, the reads agree on the least
+  bool d = ( direct == 1 );
+  double seconds = bestTime( [ & ]() { return writeFile( filename, blocks, block.get(), d ); }, comm, deviceRepeats );
+  c.parallelWrite = static_cast<double>( bytes ) * nprocs / seconds * 1e-9;
+  direct = d ? 1 : 0;
+  MPI_Allreduce( MPI_IN_PLACE, &direct, 1, MPI_INT, MPI_MIN, comm );
+  d = ( direct == 1 );
+  c.direct = d;
+  seconds = bestTime(
+    [ & ]()
+    {
+      if ( !d ) {
+        EvictFromCache( filename );
+      }
+      MPI_Barrier( comm );
+      return readFile( filename, blocks, block.get(), d );
+    }, comm, deviceRepeats );
+  c.parallelRead = static_cast<double>( bytes ) * nprocs / seconds * 1e-9;
+  ::unlink( filename.c_str() );
+
+  if ( rank == 0 ) {
+    std::cout << "Calibration [GB/s] per rank [MiB] " << ( bytes >> 20 );
+    printRate( "copy", c.copy );
+    printRate( "alltoall", c.alltoall );
+    printRate( "neighbour", c.neighbour );
+    printRate( "sequential write", c.sequentialWrite );
+    printRate( "read", c.sequentialRead );
+    printRate( "parallel write", c.parallelWrite );
+    printRate( "read", c.parallelRead );
+    std::cout << ( c.direct ? " with O_DIRECT" : " without O_DIRECT, cache dropped" ) << "\n";
+  }
+  return c;
+}
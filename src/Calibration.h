@@ -0,0 +1,39 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * Calibration.h
+ *
+ *  Created on: Oct 2026
+ *      Author: Gregor Weiss
+ *
+ *  Ceilings the rates of the schemes are compared with, measured once per
+ *  job: memory copy, MPI exchange and raw writes and reads of the output
+ *  directory with O_DIRECT, by one rank alone and by all ranks at once.
+ */
+
+#ifndef CALIBRATION_H_
+#define CALIBRATION_H_
+
+#include "Settings.h"
+
+#include <mpi.h>
+
+// Aggregate rates over all ranks in GB/s, 0 if not measured
+struct Ceilings
+{
+  double copy{ 0.0 };            // STREAM copy, bytes read plus written
+  double alltoall{ 0.0 };        // MPI_Alltoall, bytes sent to other ranks
+  double neighbour{ 0.0 };       // MPI_Sendrecv along a ring
+  double sequentialWrite{ 0.0 }; // rank 0 alone
+  double sequentialRead{ 0.0 };
+  double parallelWrite{ 0.0 };   // every rank its own file
+  double parallelRead{ 0.0 };
+  bool direct{ false };          // false: the directory refused O_DIRECT, cache dropped instead
+};
+
+// Measures the ceilings next to s.outputfile with about the local step bytes
+// per rank, rank 0 prints them, collective
+Ceilings calibrate( const Settings& s, MPI_Comm comm );
+
+#endif /* CALIBRATION_H_ */
@@ -0,0 +1,205 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * Checksum.cpp
+ *
+ *  Created on: Oct 2026
+ *      Author: Gregor Weiss
+ */
+
+#include "Checksum.h"
+#include "helper.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#if defined( __x86_64__ ) && ( defined( __GNUC__ ) || defined( __clang__ ) )
+  #include <nmmintrin.h>
+  #define HAVE_CRC32C_INSTRUCTION
+#endif
+
+namespace {
+
+// Slicing-by-8 tables of the reflected Castagnoli polynomial
+constexpr std::array<std::array<std::uint32_t, 256>, 8> makeTables() {
+  std::array<std::array<std::uint32_t, 256>, 8> tables{};
+  for ( std::uint32_t i = 0; i < 256; ++i ) {
+    std::uint32_t crc = i;
+    for ( int bit = 0; bit < 8; ++bit ) {
+      crc = ( crc & 1u ) ? ( crc >> 1 ) ^ 0x82f63b78u : crc >> 1;
+    }
+    tables[0][i] = crc;
+  }
+  for ( std::size_t k = 1; k < 8; ++k ) {
+    for ( std::size_t i = 0; i < 256; ++i ) {
+      tables[k][i] = ( tables[k - 1][i] >> 8 ) ^ tables[0][tables[k - 1][i] & 0xffu];
+    }
+  }
+  return tables;
+}
+
+constexpr auto tables = makeTables();
+
+// assumes a little-endian host like the rest of the binary formats
+std::uint32_t crc32cSoftware( const unsigned char* p, std::size_t n, std::uint32_t crc ) {
+  for ( ; n >= 8; n -= 8, p += 8 ) {
+    std::uint64_t word;
+    std::memcpy( &word, p, sizeof( word ) );
+    word ^= crc;
+    crc = tables[7][word & 0xffu] ^ tables[6][( word >> 8 ) & 0xffu]
+        ^ tables[5][( word >> 16 ) & 0xffu] ^ tables[4][( word >> 24 ) & 0xffu]
+        ^ tables[3][( word >> 32 ) & 0xffu] ^ tables[2][( word >> 40 ) & 0xffu]
+        ^ tables[1][( word >> 48 ) & 0xffu] ^ tables[0][word >> 56];
+  }
+  for ( ; n > 0; --n, ++p ) {
+    crc = ( crc >> 8 ) ^ tables[0][( crc ^ *p ) & 0xffu];
+  }
+  return crc;
+}
+
+#ifdef HAVE_CRC32C_INSTRUCTION
+__attribute__(( target( "sse4.2" ) ))
+std::uint32_t crc32cHardware( const unsigned char* p, std::size_t n, std::uint32_t crc ) {
+  std::uint64_t crc64 = crc;
+  for ( ; n >= 8; n -= 8, p += 8 ) {
+    std::uint64_t word;
+    std::memcpy( &word, p, sizeof( word ) );
+    crc64 = _mm_crc32_u64( crc64, word );
+  }
+  crc = static_cast<std::uint32_t>( crc64 );
+  for ( ; n > 0; --n, ++p ) {
+    crc = _mm_crc32_u8( crc, *p );
+  }
+  return crc;
+}
+#endif
+
+std::size_t blocksPerIteration( const Settings& s ) {
+  const std::size_t iterationBytes = sizeof( double ) * s.ndx * s.ndy * s.ndz;
+  const std::size_t blockSize = std::max( s.blockSize, 1u );
+  return ( iterationBytes + blockSize - 1 ) / blockSize;
+}
+
+std::string checksumFilename( int step, const Settings& s ) {
+  return MakeFilename( s.outputfile, ".crc", -1, step );
+}
+
+// Runs fn( iteration, block, checksum ) over all blocks of the iterations
+template<typename Function>
+void forEachBlock( const std::vector<std::vector<double> >& iterations,
+                   const Settings& s,
+                   Function fn ) {
+  const std::size_t blockSize = std::max( s.blockSize, 1u );
+  for ( std::size_t it = 0; it < iterations.size(); ++it ) {
+    const auto* data = reinterpret_cast<const char*>( iterations[it].data() );
+    const std::size_t bytes = iterations[it].size() * sizeof( double );
+    for ( std::size_t offset = 0, b = 0; offset < bytes; offset += blockSize, ++b ) {
+      fn( it, b, crc32c( data + offset, std::min( blockSize, bytes - offset ) ) );
+    }
+  }
+}
+
+} // namespace
+
+std::uint32_t crc32c( const void* data, std::size_t bytes ) {
+  const auto* p = static_cast<const unsigned char*>( data );
+#ifdef HAVE_CRC32C_INSTRUCTION
+  static const bool hardware = __builtin_cpu_supports( "sse4.2" );
+  if ( hardware ) {
+    return ~crc32cHardware( p, bytes, ~0u );
+  }
+#endif
+  return ~crc32cSoftware( p, bytes, ~0u );
+}
+
+void writeChecksums( int step,
+                     const std::vector<std::vector<double> >& iterations,
+                     const Settings& s,
+                     MPI_Comm comm ) {
+  const std::size_t perIteration = blocksPerIteration( s );
+  const std::size_t count = iterations.size() * perIteration;
+  std::vector<std::uint32_t> checksums( count );
+  forEachBlock( iterations, s,
+    [ &checksums, perIteration ]( std::size_t it, std::size_t b, std::uint32_t crc )
+    { checksums[it * perIteration + b] = crc; } );
+
+  auto filename = checksumFilename( step, s );
+  MPI_File fh;
+  MPI_File_open( comm, filename.c_str(), MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &fh );
+  MPI_Offset offset = static_cast<MPI_Offset>( getRank( comm ) ) * count * sizeof( std::uint32_t );
+  MPI_File_write_at_all( fh, offset, checksums.data(), static_cast<int>( count ),
+                         MPI_UINT32_T, MPI_STATUS_IGNORE );
+  MPI_File_close( &fh );
+}
+
+unsigned long long verifyChecksums( int step,
+                                    const std::vector<std::vector<double> >& iterations,
+                                    const Settings& s,
+                                    MPI_Comm comm ) {
+  const std::size_t perIteration = blocksPerIteration( s );
+  const std::size_t count = iterations.size() * perIteration;
+  std::vector<std::uint32_t> stored( count );
+
+  auto filename = checksumFilename( step, s );
+  MPI_File fh;
+  if ( MPI_File_open( comm, filename.c_str(), MPI_MODE_RDONLY, MPI_INFO_NULL, &fh ) != MPI_SUCCESS ) {
+    throw std::runtime_error("verifyChecksums: cannot open " + filename);
+  }
+  const int rank = getRank( comm );
+  MPI_Offset offset = static_cast<MPI_Offset>( rank ) * count * sizeof( std::uint32_t );
+  MPI_File_read_at_all( fh, offset, stored.data(), static_cast<int>( count ),
+                        MPI_UINT32_T, MPI_STATUS_IGNORE );
+  MPI_File_close( &fh );
+
+  // the first mismatches of every rank are reported as (iteration, block)
+  constexpr int reported = 8;
+  std::array<int, 2 * reported> first;
+  first.fill( -1 );
+  unsigned long long mismatches = 0;
+  forEachBlock( iterations, s,
+    [ &stored, &first, &mismatches, perIteration ]( std::size_t it, std::size_t b, std::uint32_t crc )
+    {
+      if ( crc != stored[it * perIteration + b] ) {
+        if ( mismatches < reported ) {
+          first[2 * mismatches] = static_cast<int>( it );
+          first[2 * mismatches + 1] = static_cast<int>( b );
+        }
+        ++mismatches;
+      }
+    } );
+
+  unsigned long long total = 0;
+  MPI_Allreduce( &mismatches, &total, 1, MPI_UNSIGNED_LONG_LONG, MPI_SUM, comm );
+  if ( total == 0 ) {
+    return 0;
+  }
+
+  const int nprocs = getNProcs( comm );
+  std::vector<int> all( rank == 0 ? first.size() * nprocs : 0 );
+  MPI_Gather( first.data(), static_cast<int>( first.size() ), MPI_INT,
+              all.data(), static_cast<int>( first.size() ), MPI_INT, 0, comm );
+  if ( rank == 0 ) {
+    std::cout << "WARNING: " << total << " of " << count * nprocs
+              << " blocks do not match their checksum of step " << step << "\n";
+    for ( int r = 0; r < nprocs; ++r ) {
+      for ( int m = 0; m < reported && all[first.size() * r + 2 * m] >= 0; ++m ) {
+        std::cout << "    rank " << r
+                  << " iteration " << all[first.size() * r + 2 * m]
+                  << " block " << all[first.size() * r + 2 * m + 1] << "\n";
+      }
+    }
+  }
+  return total;
+}
+
+void removeChecksums( int step, const Settings& s, MPI_Comm comm ) {
+  MPI_Barrier( comm );
+  if ( getRank( comm ) == 0 ) {
+    std::remove( checksumFilename( step, s ).c_str() );
+  }
+}
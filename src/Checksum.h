@@ -0,0 +1,45 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * Checksum.h
+ *
+ *  Created on: Oct 2026
+ *      Author: Gregor Weiss
+ *
+ *  Integrity check of the written steps without a reference copy. Every
+ *  iteration of a rank is cut into blocks of blocksize bytes, the CRC32C of
+ *  every block is stored in a sidecar file per step:
+ *
+ *    [rank 0: iteration 0 block 0 ... iteration n-1 block m-1] [rank 1: ...]
+ */
+
+#ifndef CHECKSUM_H_
+#define CHECKSUM_H_
+
+#include "Settings.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <mpi.h>
+
+// CRC32C (Castagnoli), uses the SSE4.2 instruction if the CPU has it
+std::uint32_t crc32c( const void* data, std::size_t bytes );
+
+// Computes the checksums of the iterations and writes the sidecar of step
+void writeChecksums( int step,
+                     const std::vector<std::vector<double> >& iterations,
+                     const Settings& s,
+                     MPI_Comm comm );
+
+// Checks the iterations block by block against the sidecar of step, prints
+// the mismatching blocks on rank 0 and returns their number over all ranks
+unsigned long long verifyChecksums( int step,
+                                    const std::vector<std::vector<double> >& iterations,
+                                    const Settings& s,
+                                    MPI_Comm comm );
+
+void removeChecksums( int step, const Settings& s, MPI_Comm comm );
+
+#endif /* CHECKSUM_H_ */
@@ -0,0 +1,853 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * Compression.cpp
+ *
+ *  Created on: Oct 2026
+ *      Author: Gregor Weiss
+ */
+
+#include "Compression.h"
+#include "helper.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <exception>
+#include <future>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+#ifdef HAVE_LZ4
+  #include <lz4.h>
+#endif
+#ifdef HAVE_ZSTD
+  #include <zstd.h>
+#endif
+#ifdef HAVE_ZFP
+  #include <zfp.h>
+#endif
+
+namespace {
+
+constexpr std::uint64_t frameMagic = 0x324d5246504f4948; // "HIOPFRM2"
+
+// flags at the beginning of every block
+constexpr std::uint32_t blockCompressed = 1u; // payload compressed by the codec of the frame
+constexpr std::uint32_t blockQuantized = 2u;  // payload holds quantization codes
+constexpr std::uint32_t blockZfp = 4u;        // payload is a ZFP stream
+constexpr std::uint32_t blockDelta = 8u;      // payload holds deltas to the previous iteration
+
+using Clock = std::chrono::steady_clock;
+
+double seconds( Clock::time_point begin, Clock::time_point end ) {
+  return std::chrono::duration<double>( end - begin ).count();
+}
+
+// Groups byte b of all n elements together: out[b*n + i] = in[i*8 + b]
+void byteShuffle( const char* in, char* out, std::size_t n ) {
+  for ( std::size_t b = 0; b < sizeof( double ); ++b ) {
+    char* plane = out + b * n;
+    for ( std::size_t i = 0; i < n; ++i ) {
+      plane[i] = in[i * sizeof( double ) + b];
+    }
+  }
+}
+
+void byteUnshuffle( const char* in, char* out, std::size_t n ) {
+  for ( std::size_t b = 0; b < sizeof( double ); ++b ) {
+    const char* plane = in + b * n;
+    for ( std::size_t i = 0; i < n; ++i ) {
+      out[i * sizeof( double ) + b] = plane[i];
+    }
+  }
+}
+
+// Groups bit b of all n elements together, one plane of n/8 bytes per bit.
+// Elements beyond a multiple of 8 are appended unshuffled.
+void bitShuffle( const char* in, char* out, std::size_t n ) {
+  const std::size_t groups = n / 8;
+  const auto* words = reinterpret_cast<const unsigned char*>( in );
+  auto* planes = reinterpret_cast<unsigned char*>( out );
+  for ( std::size_t bit = 0; bit < 64; ++bit ) {
+    const std::size_t byte = bit / 8;
+    const unsigned int shift = bit % 8;
+    unsigned char* plane = planes + bit * groups;
+    for ( std::size_t g = 0; g < groups; ++g ) {
+      unsigned char packed = 0;
+      for ( std::size_t e = 0; e < 8; ++e ) {
+        packed |= static_cast<unsigned char>( ( ( words[( g * 8 + e ) * 8 + byte] >> shift ) & 1u ) << e );
+      }
+      plane[g] = packed;
+    }
+  }
+  std::memcpy( out + groups * 64, in + groups * 64, ( n - groups * 8 ) * sizeof( double ) );
+}
+
+void bitUnshuffle( const char* in, char* out, std::size_t n ) {
+  const std::size_t groups = n / 8;
+  const auto* planes = reinterpret_cast<const unsigned char*>( in );
+  auto* words = reinterpret_cast<unsigned char*>( out );
+  std::memset( out, 0, groups * 64 );
+  for ( std::size_t bit = 0; bit < 64; ++bit ) {
+    const std::size_t byte = bit / 8;
+    const unsigned int shift = bit % 8;
+    const unsigned char* plane = planes + bit * groups;
+    for ( std::size_t g = 0; g < groups; ++g ) {
+      for ( std::size_t e = 0; e < 8; ++e ) {
+        words[( g * 8 + e ) * 8 + byte] |= static_cast<unsigned char>( ( ( plane[g] >> e ) & 1u ) << shift );
+      }
+    }
+  }
+  std::memcpy( out + groups * 64, in + groups * 64, ( n - groups * 8 ) * sizeof( double ) );
+}
+
+Codec parseCodec( const std::string& name ) {
+  if ( name == "none" ) { return Codec::none; }
+  if ( name == "lz4" ) {
+#ifdef HAVE_LZ4
+    return Codec::lz4;
+#else
+    throw std::invalid_argument("compression=lz4 requires building with -Dwith-lz4");
+#endif
+  }
+  if ( name == "zstd" ) {
+#ifdef HAVE_ZSTD
+    return Codec::zstd;
+#else
+    throw std::invalid_argument("compression=zstd requires building with -Dwith-zstd");
+#endif
+  }
+  throw std::invalid_argument("Invalid value given for compression: " + name);
+}
+
+Shuffle parseShuffle( const std::string& name ) {
+  if ( name == "none" ) { return Shuffle::none; }
+  if ( name == "byte" ) { return Shuffle::byte; }
+  if ( name == "bit" ) { return Shuffle::bit; }
+  throw std::invalid_argument("Invalid value given for shuffle: " + name);
+}
+
+Lossy parseLossy( const std::string& name ) {
+  if ( name == "none" ) { return Lossy::none; }
+  if ( name == "quantize" ) { return Lossy::quantize; }
+  if ( name == "zfp" ) {
+#ifdef HAVE_ZFP
+    return Lossy::zfp;
+#else
+    throw std::invalid_argument("lossy=zfp requires building with -Dwith-zfp");
+#endif
+  }
+  throw std::invalid_argument("Invalid value given for lossy: " + name);
+}
+
+Delta parseDelta( const std::string& name ) {
+  if ( name == "none" ) { return Delta::none; }
+  if ( name == "xor" ) { return Delta::bitwise; }
+  if ( name == "arith" ) { return Delta::arithmetic; }
+  throw std::invalid_argument("Invalid value given for delta: " + name);
+}
+
+// Deltas of the bit patterns of n doubles, both are exactly reversible.
+// The loops are kept branch-free so that the compiler vectorizes them.
+void deltaEncode( Delta delta,
+                  const char* current,
+                  const char* previous,
+                  std::uint64_t* out,
+                  std::size_t n ) {
+  std::uint64_t c, p;
+  if ( delta == Delta::bitwise ) {
+    for ( std::size_t i = 0; i < n; ++i ) {
+      std::memcpy( &c, current + i * sizeof( c ), sizeof( c ) );
+      std::memcpy( &p, previous + i * sizeof( p ), sizeof( p ) );
+      out[i] = c ^ p;
+    }
+  } else {
+    for ( std::size_t i = 0; i < n; ++i ) {
+      std::memcpy( &c, current + i * sizeof( c ), sizeof( c ) );
+      std::memcpy( &p, previous + i * sizeof( p ), sizeof( p ) );
+      out[i] = c - p;
+    }
+  }
+}
+
+// Turns the deltas in data back into values, in place
+void deltaDecode( Delta delta,
+                  char* data,
+                  const char* previous,
+                  std::size_t n ) {
+  std::uint64_t d, p;
+  if ( delta == Delta::bitwise ) {
+    for ( std::size_t i = 0; i < n; ++i ) {
+      std::memcpy( &d, data + i * sizeof( d ), sizeof( d ) );
+      std::memcpy( &p, previous + i * sizeof( p ), sizeof( p ) );
+      d ^= p;
+      std::memcpy( data + i * sizeof( d ), &d, sizeof( d ) );
+    }
+  } else {
+    for ( std::size_t i = 0; i < n; ++i ) {
+      std::memcpy( &d, data + i * sizeof( d ), sizeof( d ) );
+      std::memcpy( &p, previous + i * sizeof( p ), sizeof( p ) );
+      d += p;
+      std::memcpy( data + i * sizeof( d ), &d, sizeof( d ) );
+    }
+  }
+}
+
+// Error-bounded quantization in the style of SZ: every value is predicted by
+// its reconstructed predecessor and the residual is stored as a multiple of
+// 2 * tolerance, zigzag coded so that small residuals have small codes.
+// Returns false if the block cannot be held within the bound.
+bool quantize( const double* values,
+               std::size_t n,
+               double tolerance,
+               std::uint64_t* codes,
+               ErrorMetrics& error ) {
+  if ( !( tolerance > 0.0 ) ) {
+    return false;
+  }
+  constexpr double limit = 4503599627370496.0; // 2^52, exact in a double
+  const double step = 2.0 * tolerance;
+  ErrorMetrics local;
+  double previous = 0.0;
+  for ( std::size_t i = 0; i < n; ++i ) {
+    double q = std::nearbyint( ( values[i] - previous ) / step );
+    if ( !( std::fabs( q ) < limit ) ) {
+      return false;
+    }
+    double reconstructed = previous + q * step;
+    if ( !( std::fabs( values[i] - reconstructed ) <= tolerance ) ) {
+      return false;
+    }
+    auto code = static_cast<std::int64_t>( q );
+    codes[i] = ( static_cast<std::uint64_t>( code ) << 1 ) ^ static_cast<std::uint64_t>( code >> 63 );
+    local.add( values[i], reconstructed );
+    previous = reconstructed;
+  }
+  error = local;
+  return true;
+}
+
+void dequantize( const std::uint64_t* codes,
+                 std::size_t n,
+                 double tolerance,
+                 double* values ) {
+  const double step = 2.0 * tolerance;
+  double previous = 0.0;
+  for ( std::size_t i = 0; i < n; ++i ) {
+    auto code = static_cast<std::int64_t>( codes[i] >> 1 ) ^ -static_cast<std::int64_t>( codes[i] & 1u );
+    previous = previous + static_cast<double>( code ) * step;
+    values[i] = previous;
+  }
+}
+
+// Metrics of a block that is stored without loss
+ErrorMetrics exact( const double* values, std::size_t n ) {
+  ErrorMetrics error;
+  for ( std::size_t i = 0; i < n; ++i ) {
+    error.add( values[i], values[i] );
+  }
+  return error;
+}
+
+#ifdef HAVE_ZFP
+// Writes the fixed-accuracy ZFP stream of the values to out at offset
+void zfpEncode( const double* values,
+                std::size_t n,
+                double tolerance,
+                std::vector<char>& out,
+                std::size_t offset ) {
+  zfp_field* field = zfp_field_1d( const_cast<double*>( values ), zfp_type_double, n );
+  zfp_stream* zfp = zfp_stream_open( nullptr );
+  zfp_stream_set_accuracy( zfp, tolerance );
+  out.resize( offset + zfp_stream_maximum_size( zfp, field ) );
+  bitstream* stream = stream_open( out.data() + offset, out.size() - offset );
+  zfp_stream_set_bit_stream( zfp, stream );
+  zfp_stream_rewind( zfp );
+  std::size_t size = zfp_compress( zfp, field );
+  zfp_field_free( field );
+  zfp_stream_close( zfp );
+  stream_close( stream );
+  if ( size == 0 ) {
+    throw std::runtime_error("zfp_compress failed");
+  }
+  out.resize( offset + size );
+}
+
+void zfpDecode( const char* src,
+                std::size_t bytes,
+                double tolerance,
+                double* values,
+                std::size_t n ) {
+  zfp_field* field = zfp_field_1d( values, zfp_type_double, n );
+  zfp_stream* zfp = zfp_stream_open( nullptr );
+  zfp_stream_set_accuracy( zfp, tolerance );
+  bitstream* stream = stream_open( const_cast<char*>( src ), bytes );
+  zfp_stream_set_bit_stream( zfp, stream );
+  zfp_stream_rewind( zfp );
+  std::size_t size = zfp_decompress( zfp, field );
+  zfp_field_free( field );
+  zfp_stream_close( zfp );
+  stream_close( stream );
+  if ( size == 0 ) {
+    throw std::runtime_error("CompressionStage::decode: corrupt ZFP block");
+  }
+}
+#endif
+
+// Position of a block within the iterations
+struct BlockRange
+{
+  std::size_t iteration;
+  std::size_t offset; // bytes
+  std::size_t bytes;
+};
+
+std::vector<BlockRange> blockRanges( std::size_t iterations,
+                                     std::size_t iterationBytes,
+                                     std::size_t blockSize ) {
+  std::vector<BlockRange> ranges;
+  for ( std::size_t it = 0; it < iterations; ++it ) {
+    for ( std::size_t offset = 0; offset < iterationBytes; offset += blockSize ) {
+      ranges.push_back( { it, offset, std::min( blockSize, iterationBytes - offset ) } );
+    }
+  }
+  return ranges;
+}
+
+} // namespace
+
+CompressionStage::CompressionStage( const Settings& s, MPI_Comm comm )
+  : _codec{ parseCodec( s.compression ) }
+  , _shuffle{ parseShuffle( s.shuffle ) }
+  , _lossy{ parseLossy( s.lossy ) }
+  , _delta{ parseDelta( s.delta ) }
+  , _tolerance{ s.tolerance }
+  , _targetPsnr{ _lossy == Lossy::none ? 0.0 : s.psnr }
+  , _blockSize{ std::max<std::size_t>( s.blockSize / sizeof( double ), 1 ) * sizeof( double ) }
+  , _threads{ std::max( s.threads, 1u ) }
+  , _communicator{ comm } {}
+
+ErrorMetrics CompressionStage::roundTrip( const double* values, std::size_t n, double tolerance ) const {
+#ifdef HAVE_ZFP
+  if ( _lossy == Lossy::zfp && tolerance > 0.0 ) {
+    std::vector<char> stream;
+    std::vector<double> decoded( n );
+    zfpEncode( values, n, tolerance, stream, 0 );
+    zfpDecode( stream.data(), stream.size(), tolerance, decoded.data(), n );
+    ErrorMetrics error;
+    for ( std::size_t i = 0; i < n; ++i ) {
+      error.add( values[i], decoded[i] );
+    }
+    return error;
+  }
+#endif
+  ErrorMetrics error;
+  std::vector<std::uint64_t> codes( n );
+  if ( _lossy == Lossy::quantize && quantize( values, n, tolerance, codes.data(), error ) ) {
+    return error;
+  }
+  return exact( values, n );
+}
+
+void CompressionStage::tune( const std::vector<std::vector<double> >& iterations ) {
+  const std::size_t iterationBytes = iterations.empty() ? 0 : iterations.front().size() * sizeof( double );
+  const auto ranges = blockRanges( iterations.size(), iterationBytes, _blockSize );
+
+  auto localError = [ this, &iterations, &ranges ]( double tolerance )
+  {
+    std::vector<ErrorMetrics> errors( ranges.size() );
+    parallelFor( ranges.size(), _threads,
+      [ this, &iterations, &ranges, &errors, tolerance ]( std::size_t n )
+      {
+        const double* values = iterations[ranges[n].iteration].data() + ranges[n].offset / sizeof( double );
+        errors[n] = roundTrip( values, ranges[n].bytes / sizeof( double ), tolerance );
+      } );
+    ErrorMetrics error;
+    for ( const auto& e : errors ) {
+      error.merge( e );
+    }
+    return error;
+  };
+
+  // the tolerance is a power-of-two fraction of the global value range,
+  // the PSNR grows with the exponent k, search the smallest k on target
+  const ErrorMetrics global = localError( 0.0 ).reduce( _communicator );
+  const double range = global.count > 0.0 ? global.max - global.min : 0.0;
+  int lo = 1;
+  int hi = 52;
+  while ( range > 0.0 && lo < hi ) {
+    int k = ( lo + hi ) / 2;
+    if ( localError( std::ldexp( range, -k ) ).reduce( _communicator ).psnr() >= _targetPsnr ) {
+      hi = k;
+    } else {
+      lo = k + 1;
+    }
+  }
+  _tolerance = range > 0.0 ? std::ldexp( range, -lo ) : 0.0;
+  _tuned = true;
+}
+
+void CompressionStage::encode( const std::vector<std::vector<double> >& iterations,
+                               const std::function<void(const char*, std::size_t)>& sink ) {
+  // collective over the communicator on the first step
+  if ( _targetPsnr > 0.0 && !_tuned ) {
+    tune( iterations );
+  }
+
+  const auto begin = Clock::now();
+  const std::size_t iterationBytes = iterations.empty() ? 0 : iterations.front().size() * sizeof( double );
+  const auto ranges = blockRanges( iterations.size(), iterationBytes, _blockSize );
+
+  std::vector<EncodedBlock> blocks( ranges.size() );
+  std::vector<std::promise<void> > ready( ranges.size() );
+  std::vector<Clock::time_point> finished( ranges.size(), begin );
+
+  // compress on a pool of workers, the blocks are taken in order
+  std::atomic<std::size_t> next{ 0 };
+  auto worker = [ this, &iterations, &ranges, &blocks, &ready, &finished, &next ]()
+  {
+    for ( std::size_t n = next++; n < ranges.size(); n = next++ ) {
+      try {
+        const auto it = ranges[n].iteration;
+        const char* src = reinterpret_cast<const char*>( iterations[it].data() ) + ranges[n].offset;
+        const char* reference = it == 0 ? nullptr
+                                        : reinterpret_cast<const char*>( iterations[it - 1].data() ) + ranges[n].offset;
+        blocks[n] = encodeBlock( src, reference, ranges[n].bytes );
+        finished[n] = Clock::now();
+        ready[n].set_value();
+      } catch ( ... ) {
+        ready[n].set_exception( std::current_exception() );
+      }
+    }
+  };
+  std::vector<std::thread> pool;
+  for ( unsigned int t = 0; t < _threads; ++t ) {
+    pool.emplace_back( worker );
+  }
+
+  // meanwhile hand the finished blocks to the backend
+  std::vector<std::uint64_t> table( ranges.size() );
+  double writeTime = 0.0;
+  std::exception_ptr error;
+  for ( std::size_t n = 0; n < ranges.size(); ++n ) {
+    try {
+      ready[n].get_future().get();
+      const auto& data = blocks[n].data;
+      table[n] = data.size();
+      const auto start = Clock::now();
+      sink( data.data(), data.size() );
+      writeTime += seconds( start, Clock::now() );
+      _report.error.merge( blocks[n].error );
+      std::vector<char>().swap( blocks[n].data );
+    } catch ( ... ) {
+      error = std::current_exception();
+      // keep consuming so that no worker is left behind
+      for ( std::size_t m = n + 1; m < ranges.size(); ++m ) {
+        ready[m].get_future().wait();
+      }
+      break;
+    }
+  }
+  for ( auto& thread : pool ) {
+    thread.join();
+  }
+  if ( error ) {
+    std::rethrow_exception( error );
+  }
+
+  FrameFooter footer{ frameMagic,
+                      static_cast<std::uint32_t>( _codec ),
+                      static_cast<std::uint32_t>( _shuffle ),
+                      static_cast<std::uint32_t>( _lossy ),
+                      static_cast<std::uint32_t>( _delta ),
+                      _blockSize,
+                      iterationBytes,
+                      iterations.size(),
+                      ranges.size(),
+                      _tolerance };
+  const auto start = Clock::now();
+  sink( reinterpret_cast<const char*>( table.data() ), table.size() * sizeof( std::uint64_t ) );
+  sink( reinterpret_cast<const char*>( &footer ), sizeof( footer ) );
+  const auto end = Clock::now();
+  writeTime += seconds( start, end );
+
+  double stored = sizeof( footer ) + table.size() * sizeof( std::uint64_t );
+  for ( auto size : table ) {
+    stored += static_cast<double>( size );
+  }
+  _report.rawBytes += static_cast<double>( iterationBytes * iterations.size() );
+  _report.storedBytes += stored;
+  _report.compressTime += seconds( begin, ranges.empty() ? begin : *std::max_element( finished.begin(), finished.end() ) );
+  _report.writeTime += writeTime;
+  _report.elapsedTime += seconds( begin, end );
+  _report.tolerance = _lossy == Lossy::none ? 0.0 : _tolerance;
+}
+
+std::vector<char> CompressionStage::encode( const std::vector<std::vector<double> >& iterations ) {
+  std::vector<char> frame;
+  // appending to memory is not a write, see addWriteTime
+  const Report before = _report;
+  encode( iterations,
+          [ &frame ]( const char* data, std::size_t bytes )
+          { frame.insert( frame.end(), data, data + bytes ); } );
+  _report.writeTime = before.writeTime;
+  return frame;
+}
+
+void CompressionStage::decode( const std::vector<char>& frame,
+                               std::vector<std::vector<double> >& iterations ) {
+  const auto begin = Clock::now();
+  FrameFooter footer;
+  if ( frame.size() < sizeof( footer ) ) {
+    throw std::runtime_error("CompressionStage::decode: truncated frame");
+  }
+  std::memcpy( &footer, frame.data() + frame.size() - sizeof( footer ), sizeof( footer ) );
+  if ( footer.magic != frameMagic
+       || footer.iterations != iterations.size()
+       || ( !iterations.empty() && footer.iterationBytes != iterations.front().size() * sizeof( double ) ) ) {
+    throw std::runtime_error("CompressionStage::decode: frame does not match the read buffer");
+  }
+
+  const auto ranges = blockRanges( footer.iterations, footer.iterationBytes, footer.blockSize );
+  if ( ranges.size() != footer.blocks
+       || frame.size() < sizeof( footer ) + footer.blocks * sizeof( std::uint64_t ) ) {
+    throw std::runtime_error("CompressionStage::decode: corrupt block table");
+  }
+  std::vector<std::uint64_t> table( footer.blocks );
+  const char* tableBegin = frame.data() + frame.size() - sizeof( footer ) - table.size() * sizeof( std::uint64_t );
+  std::memcpy( table.data(), tableBegin, table.size() * sizeof( std::uint64_t ) );
+
+  std::vector<std::size_t> offsets( table.size() + 1, 0 );
+  for ( std::size_t n = 0; n < table.size(); ++n ) {
+    offsets[n + 1] = offsets[n] + table[n];
+  }
+
+  auto decodeAt = [ this, &footer, &frame, &ranges, &table, &offsets, &iterations ]( std::size_t n )
+  {
+    const auto it = ranges[n].iteration;
+    char* dst = reinterpret_cast<char*>( iterations[it].data() ) + ranges[n].offset;
+    const char* previous = it == 0 ? nullptr
+                                   : reinterpret_cast<const char*>( iterations[it - 1].data() ) + ranges[n].offset;
+    decodeBlock( footer, frame.data() + offsets[n], table[n], dst, previous, ranges[n].bytes );
+  };
+
+  if ( static_cast<Delta>( footer.delta ) == Delta::none ) {
+    parallelFor( ranges.size(), _threads, decodeAt );
+  } else {
+    // a block depends on the same block of the previous iteration: the
+    // threads share the block positions and run through the iterations in order
+    const std::size_t perIteration = footer.iterations == 0 ? 0 : ranges.size() / footer.iterations;
+    parallelFor( perIteration, _threads,
+      [ &decodeAt, &footer, perIteration ]( std::size_t b )
+      {
+        for ( std::size_t it = 0; it < footer.iterations; ++it ) {
+          decodeAt( it * perIteration + b );
+        }
+      } );
+  }
+
+  _report.decodeTime += seconds( begin, Clock::now() );
+}
+
+CompressionStage::EncodedBlock CompressionStage::encodeBlock( const char* src,
+                                                             const char* reference,
+                                                             std::size_t bytes ) const {
+  EncodedBlock block;
+  const std::size_t n = bytes / sizeof( double );
+  const auto* values = reinterpret_cast<const double*>( src );
+  std::uint32_t flags = 0;
+  constexpr std::size_t header = sizeof( flags );
+
+#ifdef HAVE_ZFP
+  if ( _lossy == Lossy::zfp && _tolerance > 0.0 ) {
+    zfpEncode( values, n, _tolerance, block.data, header );
+    flags = blockZfp;
+    std::memcpy( block.data.data(), &flags, header );
+    // the achieved error is only known from the decoded block
+    std::vector<double> decoded( n );
+    zfpDecode( block.data.data() + header, block.data.size() - header, _tolerance, decoded.data(), n );
+    for ( std::size_t i = 0; i < n; ++i ) {
+      block.error.add( values[i], decoded[i] );
+    }
+    return block;
+  }
+#endif
+
+  // deltas or quantization codes take the place of the values
+  std::vector<std::uint64_t> codes;
+  if ( _delta != Delta::none && reference != nullptr ) {
+    codes.resize( n );
+    deltaEncode( _delta, src, reference, codes.data(), n );
+    flags |= blockDelta;
+    src = reinterpret_cast<const char*>( codes.data() );
+  } else if ( _lossy == Lossy::quantize ) {
+    codes.resize( n );
+    if ( quantize( values, n, _tolerance, codes.data(), block.error ) ) {
+      flags |= blockQuantized;
+      src = reinterpret_cast<const char*>( codes.data() );
+    } else {
+      block.error = exact( values, n );
+    }
+  }
+
+  std::vector<char> shuffled( bytes );
+  switch ( _shuffle ) {
+    case Shuffle::byte: byteShuffle( src, shuffled.data(), n ); break;
+    case Shuffle::bit:  bitShuffle( src, shuffled.data(), n ); break;
+    default:            std::memcpy( shuffled.data(), src, bytes ); break;
+  }
+
+  std::size_t size = bytes;
+  switch ( _codec ) {
+#ifdef HAVE_LZ4
+    case Codec::lz4: {
+      block.data.resize( header + static_cast<std::size_t>( LZ4_compressBound( static_cast<int>( bytes ) ) ) );
+      size = static_cast<std::size_t>( LZ4_compress_default( shuffled.data(),
+                                                             block.data.data() + header,
+                                                             static_cast<int>( bytes ),
+                                                             static_cast<int>( block.data.size() - header ) ) );
+      if ( size == 0 ) {
+        throw std::runtime_error("LZ4_compress_default failed");
+      }
+      break;
+    }
+#endif
+#ifdef HAVE_ZSTD
+    case Codec::zstd: {
+      block.data.resize( header + ZSTD_compressBound( bytes ) );
+      size = ZSTD_compress( block.data.data() + header, block.data.size() - header, shuffled.data(), bytes, 1 );
+      if ( ZSTD_isError( size ) ) {
+        throw std::runtime_error( std::string( "ZSTD_compress failed: " ) + ZSTD_getErrorName( size ) );
+      }
+      break;
+    }
+#endif
+    default:
+      break;
+  }
+
+  // incompressible blocks are stored as they are
+  if ( size < bytes ) {
+    flags |= blockCompressed;
+  } else {
+    size = bytes;
+    block.data.resize( header + bytes );
+    std::memcpy( block.data.data() + header, shuffled.data(), bytes );
+  }
+  block.data.resize( header + size );
+  std::memcpy( block.data.data(), &flags, header );
+  return block;
+}
+
+void CompressionStage::decodeBlock( const FrameFooter& footer,
+                                    const char* src,
+                                    std::size_t storedBytes,
+                                    char* dst,
+                                    const char* previous,
+                                    std::size_t bytes ) const {
+  std::uint32_t flags;
+  if ( storedBytes < sizeof( flags ) ) {
+    throw std::runtime_error("CompressionStage::decode: corrupt block");
+  }
+  std::memcpy( &flags, src, sizeof( flags ) );
+  src += sizeof( flags );
+  storedBytes -= sizeof( flags );
+  const std::size_t n = bytes / sizeof( double );
+
+  if ( flags & blockZfp ) {
+#ifdef HAVE_ZFP
+    zfpDecode( src, storedBytes, footer.tolerance, reinterpret_cast<double*>( dst ), n );
+    return;
+#else
+    throw std::runtime_error("CompressionStage::decode: ZFP is not available");
+#endif
+  }
+
+  std::vector<char> shuffled( bytes );
+  if ( !( flags & blockCompressed ) ) {
+    if ( storedBytes != bytes ) {
+      throw std::runtime_error("CompressionStage::decode: corrupt block");
+    }
+    std::memcpy( shuffled.data(), src, bytes );
+  } else {
+    std::size_t size = 0;
+    switch ( static_cast<Codec>( footer.codec ) ) {
+#ifdef HAVE_LZ4
+      case Codec::lz4: {
+        int ret = LZ4_decompress_safe( src,
+                                       shuffled.data(),
+                                       static_cast<int>( storedBytes ),
+                                       static_cast<int>( bytes ) );
+        size = ret < 0 ? 0 : static_cast<std::size_t>( ret );
+        break;
+      }
+#endif
+#ifdef HAVE_ZSTD
+      case Codec::zstd: {
+        size = ZSTD_decompress( shuffled.data(), bytes, src, storedBytes );
+        if ( ZSTD_isError( size ) ) {
+          size = 0;
+        }
+        break;
+      }
+#endif
+      default:
+        throw std::runtime_error("CompressionStage::decode: codec of the frame is not available");
+    }
+    if ( size != bytes ) {
+      throw std::runtime_error("CompressionStage::decode: corrupt block");
+    }
+  }
+
+  std::vector<std::uint64_t> codes;
+  char* plain = dst;
+  if ( flags & blockQuantized ) {
+    codes.resize( n );
+    plain = reinterpret_cast<char*>( codes.data() );
+  }
+  switch ( static_cast<Shuffle>( footer.shuffle ) ) {
+    case Shuffle::byte: byteUnshuffle( shuffled.data(), plain, n ); break;
+    case Shuffle::bit:  bitUnshuffle( shuffled.data(), plain, n ); break;
+    default:            std::memcpy( plain, shuffled.data(), bytes ); break;
+  }
+  if ( flags & blockQuantized ) {
+    dequantize( codes.data(), n, footer.tolerance, reinterpret_cast<double*>( dst ) );
+  }
+  if ( flags & blockDelta ) {
+    if ( previous == nullptr ) {
+      throw std::runtime_error("CompressionStage::decode: delta block without a previous iteration");
+    }
+    deltaDecode( static_cast<Delta>( footer.delta ), dst, previous, n );
+  }
+}
+
+namespace {
+
+// MPI counts are int, larger transfers are split into chunks.
+// Collective calls are repeated on every rank the same number of times.
+constexpr MPI_Offset maxChunk = 1 << 30;
+
+template<typename Transfer>
+void chunked( MPI_Offset offset, char* data, MPI_Offset bytes, MPI_Comm comm, bool collective, Transfer transfer ) {
+  long long chunks = ( bytes + maxChunk - 1 ) / maxChunk;
+  if ( collective ) {
+    MPI_Allreduce( MPI_IN_PLACE, &chunks, 1, MPI_LONG_LONG, MPI_MAX, comm );
+  }
+  for ( long long c = 0; c < chunks; ++c ) {
+    MPI_Offset begin = std::min( bytes, c * maxChunk );
+    MPI_Offset count = std::min( maxChunk, bytes - begin );
+    transfer( offset + begin, data + begin, static_cast<int>( count ) );
+  }
+}
+
+} // namespace
+
+void writeFrames( MPI_File fh,
+                  const std::vector<char>& frame,
+                  MPI_Comm comm,
+                  bool collective ) {
+  int rank, nprocs;
+  MPI_Comm_rank( comm, &rank );
+  MPI_Comm_size( comm, &nprocs );
+
+  // frames follow the index in rank order
+  long long size = static_cast<long long>( frame.size() );
+  long long offset = 0;
+  MPI_Exscan( &size, &offset, 1, MPI_LONG_LONG, MPI_SUM, comm );
+  if ( rank == 0 ) {
+    offset = 0;
+  }
+  offset += static_cast<long long>( nprocs ) * 2 * sizeof( long long );
+
+  long long entry[2] = { offset, size };
+  MPI_Offset entryOffset = static_cast<MPI_Offset>( rank ) * sizeof( entry );
+  auto* data = const_cast<char*>( frame.data() );
+  if ( collective ) {
+    MPI_File_write_at_all( fh, entryOffset, entry, 2, MPI_LONG_LONG, MPI_STATUS_IGNORE );
+    chunked( offset, data, size, comm, collective,
+      [ fh ]( MPI_Offset at, char* buf, int count )
+      { MPI_File_write_at_all( fh, at, buf, count, MPI_BYTE, MPI_STATUS_IGNORE ); } );
+  } else {
+    MPI_File_write_at( fh, entryOffset, entry, 2, MPI_LONG_LONG, MPI_STATUS_IGNORE );
+    chunked( offset, data, size, comm, collective,
+      [ fh ]( MPI_Offset at, char* buf, int count )
+      { MPI_File_write_at( fh, at, buf, count, MPI_BYTE, MPI_STATUS_IGNORE ); } );
+  }
+}
+
+std::vector<char> readFrame( MPI_File fh,
+                             MPI_Comm comm,
+                             bool collective ) {
+  int rank;
+  MPI_Comm_rank( comm, &rank );
+
+  long long entry[2] = { 0, 0 };
+  MPI_Offset entryOffset = static_cast<MPI_Offset>( rank ) * sizeof( entry );
+  std::vector<char> frame;
+  if ( collective ) {
+    MPI_File_read_at_all( fh, entryOffset, entry, 2, MPI_LONG_LONG, MPI_STATUS_IGNORE );
+    frame.resize( static_cast<std::size_t>( entry[1] ) );
+    chunked( entry[0], frame.data(), entry[1], comm, collective,
+      [ fh ]( MPI_Offset at, char* buf, int count )
+      { MPI_File_read_at_all( fh, at, buf, count, MPI_BYTE, MPI_STATUS_IGNORE ); } );
+  } else {
+    MPI_File_read_at( fh, entryOffset, entry, 2, MPI_LONG_LONG, MPI_STATUS_IGNORE );
+    frame.resize( static_cast<std::size_t>( entry[1] ) );
+    chunked( entry[0], frame.data(), entry[1], comm, collective,
+      [ fh ]( MPI_Offset at, char* buf, int count )
+      { MPI_File_read_at( fh, at, buf, count, MPI_BYTE, MPI_STATUS_IGNORE ); } );
+  }
+  return frame;
+}
+
+void printCompression( std::string_view identifier,
+                       const CompressionStage::Report& report,
+                       MPI_Comm comm ) {
+  double bytes[2] = { report.rawBytes, report.storedBytes };
+  double sums[2] = { 0.0, 0.0 };
+  // seconds in which compressing and writing ran at the same time
+  double overlap = std::max( 0.0, report.compressTime + report.writeTime - report.elapsedTime );
+  double times[5] = { report.compressTime, report.writeTime, overlap, report.decodeTime, report.elapsedTime };
+  double maxima[5] = { 0.0, 0.0, 0.0, 0.0, 0.0 };
+  MPI_Reduce( bytes, sums, 2, MPI_DOUBLE, MPI_SUM, 0, comm );
+  MPI_Reduce( times, maxima, 5, MPI_DOUBLE, MPI_MAX, 0, comm );
+
+  // the tolerance is the same on all ranks, so is the decision to reduce
+  ErrorMetrics error;
+  if ( report.tolerance > 0.0 ) {
+    error = report.error.reduce( comm );
+  }
+
+  int rank;
+  MPI_Comm_rank( comm, &rank );
+  if ( rank == 0 ) {
+    std::cout << identifier;
+    if ( sums[1] > 0.0 ) {
+      std::cout << " ratio " << sums[0] / sums[1]
+                << " stored [GB] " << sums[1] / 1e9
+                << " max. compress [s] " << maxima[0]
+                << " max. write [s] " << maxima[1]
+                << " max. overlap [s] " << maxima[2];
+      if ( maxima[4] > 0.0 ) {
+        std::cout << " effective [GB/s] " << sums[0] / 1e9 / maxima[4];
+      }
+    }
+    if ( report.tolerance > 0.0 ) {
+      std::cout << " tolerance " << report.tolerance;
+      if ( error.count > 0.0 ) {
+        std::cout << " MSE " << error.mse()
+                  << " PSNR [dB] " << error.psnr()
+                  << " max. error " << error.maxAbsError;
+      }
+    }
+    if ( maxima[3] > 0.0 ) {
+      std::cout << " max. decode [s] " << maxima[3];
+    }
+    std::cout << "\n";
+  }
+}
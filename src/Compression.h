@@ -0,0 +1,153 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * Compression.h
+ *
+ *  Created on: Oct 2026
+ *      Author: Gregor Weiss
+ *
+ *  Compression stage for the backends without ADIOS2 operators.
+ *  The iterations of a step are cut into fixed-size blocks, every block is
+ *  optionally quantized within an error bound (or compressed by ZFP) or
+ *  replaced by its delta to the previous iteration, shuffled and compressed
+ *  by a pool of threads. A frame holds the blocks
+ *  followed by a table of block sizes and a footer:
+ *
+ *    [block 0] ... [block n-1] [n x uint64 block size] [FrameFooter]
+ *
+ *  Every block starts with a uint32 of flags telling how it was encoded.
+ */
+
+#ifndef COMPRESSION_H_
+#define COMPRESSION_H_
+
+#include "Metrics.h"
+#include "Settings.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <mpi.h>
+
+enum class Codec : std::uint32_t { none, lz4, zstd };
+enum class Shuffle : std::uint32_t { none, byte, bit };
+enum class Lossy : std::uint32_t { none, quantize, zfp };
+enum class Delta : std::uint32_t { none, bitwise, arithmetic }; // xor or difference of the bit patterns
+
+struct FrameFooter
+{
+  std::uint64_t magic;
+  std::uint32_t codec;
+  std::uint32_t shuffle;
+  std::uint32_t lossy;
+  std::uint32_t delta;
+  std::uint64_t blockSize;      // raw bytes per block, the last block of an iteration may be shorter
+  std::uint64_t iterationBytes; // raw bytes per iteration
+  std::uint64_t iterations;
+  std::uint64_t blocks;
+  double tolerance;             // absolute error bound of the lossy blocks
+};
+
+class CompressionStage
+{
+ public:
+  // Accumulated since the last reset, times in seconds
+  struct Report
+  {
+    double rawBytes{ 0.0 };
+    double storedBytes{ 0.0 };
+    double compressTime{ 0.0 }; // first block started until last block compressed
+    double writeTime{ 0.0 };    // spent handing blocks to the backend
+    double elapsedTime{ 0.0 };  // whole encode including the writes
+    double decodeTime{ 0.0 };
+    double tolerance{ 0.0 };    // error bound in use, 0 if lossless
+    ErrorMetrics error{};       // local error of the lossy blocks where it is known
+  };
+
+  CompressionStage() = default;
+
+  CompressionStage( const Settings& s, MPI_Comm comm );
+
+  bool enabled() const {
+    return _codec != Codec::none || _lossy != Lossy::none || _delta != Delta::none;
+  }
+
+  // Compresses the iterations and hands the frame to sink piece by piece,
+  // blocks are written while the following ones are still compressed
+  void encode( const std::vector<std::vector<double> >& iterations,
+               const std::function<void(const char*, std::size_t)>& sink );
+
+  // Compresses the iterations into one contiguous frame
+  std::vector<char> encode( const std::vector<std::vector<double> >& iterations );
+
+  // Restores the iterations from a complete frame
+  void decode( const std::vector<char>& frame,
+               std::vector<std::vector<double> >& iterations );
+
+  // Accounts a write of a frame encoded into memory
+  void addWriteTime( double seconds ) {
+    _report.writeTime += seconds;
+    _report.elapsedTime += seconds;
+  }
+
+  const Report& report() const { return _report; }
+
+  void resetReport() { _report = Report{}; }
+
+ private:
+  struct EncodedBlock
+  {
+    std::vector<char> data;
+    ErrorMetrics error;
+  };
+
+  // reference is the same block of the previous iteration, nullptr for the first
+  EncodedBlock encodeBlock( const char* src, const char* reference, std::size_t bytes ) const;
+
+  // error of a block compressed with the given tolerance
+  ErrorMetrics roundTrip( const double* values, std::size_t n, double tolerance ) const;
+
+  // chooses the coarsest tolerance that reaches the target PSNR over all processes
+  void tune( const std::vector<std::vector<double> >& iterations );
+
+  void decodeBlock( const FrameFooter& footer,
+                    const char* src,
+                    std::size_t storedBytes,
+                    char* dst,
+                    const char* previous,
+                    std::size_t bytes ) const;
+
+  Codec _codec{ Codec::none };
+  Shuffle _shuffle{ Shuffle::none };
+  Lossy _lossy{ Lossy::none };
+  Delta _delta{ Delta::none };
+  double _tolerance{ 0.0 };
+  double _targetPsnr{ 0.0 };
+  bool _tuned{ false };
+  std::size_t _blockSize{ 0 };
+  unsigned int _threads{ 1 };
+  MPI_Comm _communicator{ MPI_COMM_NULL };
+  Report _report{};
+};
+
+// Shared-file layout of the MPI-IO backends: an index of (offset, size) per
+// rank followed by the frames of all ranks, offsets are computed by MPI_Exscan
+void writeFrames( MPI_File fh,
+                  const std::vector<char>& frame,
+                  MPI_Comm comm,
+                  bool collective );
+
+std::vector<char> readFrame( MPI_File fh,
+                             MPI_Comm comm,
+                             bool collective );
+
+// Prints the compression report of all ranks of comm on rank 0
+void printCompression( std::string_view identifier,
+                       const CompressionStage::Report& report,
+                       MPI_Comm comm );
+
+#endif /* COMPRESSION_H_ */
@@ -0,0 +1,213 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * Counters.cpp
+ *
+ *  Created on: Oct 2026
+ *      Author: Gregor Weiss
+ */
+
+#include "Counters.h"
+#include "helper.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace counters {
+
+thread_local bool enabled = false;
+
+namespace {
+
+constexpr std::array<const char*, Counter::count> counterNames{
+  "cycles", "instructions", "llc-load-misses", "llc-store-misses" };
+
+// bytes moved between the last level cache and memory per miss
+constexpr double lineBytes = 64.0;
+
+struct Group
+{
+  int leader{ -1 };
+  std::array<int, Counter::count> fds{ -1, -1, -1, -1 };
+  std::array<int, Counter::count> slots{ -1, -1, -1, -1 }; // position in a group read
+  int opened{ 0 };
+  std::string description{};
+};
+
+thread_local Group group;
+
+struct Totals
+{
+  double calls{ 0.0 };
+  double seconds{ 0.0 };
+  double flops{ 0.0 };
+  std::array<double, Counter::count> values{};
+};
+
+// updated by the enabled thread only
+std::array<Totals, regionCount> totals{};
+
+perf_event_attr attributes( Counter counter ) {
+  perf_event_attr attr;
+  std::memset( &attr, 0, sizeof( attr ) );
+  attr.size = sizeof( attr );
+  auto cache = []( unsigned long long op )
+  { return PERF_COUNT_HW_CACHE_LL | ( op << 8 ) | ( PERF_COUNT_HW_CACHE_RESULT_MISS << 16 ); };
+  switch ( counter ) {
+    case cycles:
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.config = PERF_COUNT_HW_CPU_CYCLES;
+      break;
+    case instructions:
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+      break;
+    case loadMisses:
+      attr.type = PERF_TYPE_HW_CACHE;
+      attr.config = cache( PERF_COUNT_HW_CACHE_OP_READ );
+      break;
+    case storeMisses:
+      attr.type = PERF_TYPE_HW_CACHE;
+      attr.config = cache( PERF_COUNT_HW_CACHE_OP_WRITE );
+      break;
+    default:
+      break;
+  }
+  // user space only, allowed with perf_event_paranoid up to 2
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  return attr;
+}
+
+int open( perf_event_attr& attr, int leader ) {
+  attr.disabled = ( leader == -1 );
+  return static_cast<int>( syscall( SYS_perf_event_open, &attr, 0, -1, leader, 0 ) );
+}
+
+} // namespace
+
+std::string start() {
+  enabled = true;
+  if ( !group.description.empty() ) {
+    return group.description;
+  }
+  int error = 0;
+  std::string names;
+  for ( std::size_t c = 0; c < Counter::count; ++c ) {
+    perf_event_attr attr = attributes( static_cast<Counter>( c ) );
+    int fd = open( attr, group.leader );
+    if ( fd < 0 && c == loadMisses ) {
+      // the generic last level cache misses where the cache events are missing
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.config = PERF_COUNT_HW_CACHE_MISSES;
+      fd = open( attr, group.leader );
+    }
+    if ( fd < 0 ) {
+      error = errno;
+      continue;
+    }
+    if ( group.leader == -1 ) {
+      group.leader = fd;
+    }
+    group.fds[c] = fd;
+    group.slots[c] = group.opened++;
+    names += ( names.empty() ? "" : " " ) + std::string( counterNames[c] );
+  }
+  if ( group.leader == -1 ) {
+    group.description = std::string( "none, perf_event_open: " ) + std::strerror( error );
+    return group.description;
+  }
+  ioctl( group.leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP );
+  ioctl( group.leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP );
+  group.description = names;
+  return names;
+}
+
+std::array<std::uint64_t, Counter::count> read() {
+  std::array<std::uint64_t, Counter::count> values{};
+  if ( group.leader < 0 ) {
+    return values;
+  }
+  // nr, time enabled, time running, one value per counter
+  std::uint64_t buffer[3 + Counter::count];
+  if ( ::read( group.leader, buffer, sizeof( buffer ) ) < static_cast<ssize_t>( 3 * sizeof( std::uint64_t ) ) ) {
+    return values;
+  }
+  // the counters were multiplexed with others
+  const double scale = ( buffer[2] > 0 && buffer[2] < buffer[1] )
+                     ? static_cast<double>( buffer[1] ) / static_cast<double>( buffer[2] ) : 1.0;
+  for ( std::size_t c = 0; c < Counter::count; ++c ) {
+    if ( group.slots[c] >= 0 && static_cast<std::uint64_t>( group.slots[c] ) < buffer[0] ) {
+      values[c] = static_cast<std::uint64_t>( static_cast<double>( buffer[3 + group.slots[c]] ) * scale );
+    }
+  }
+  return values;
+}
+
+void add( Region region, double seconds, const std::array<std::uint64_t, Counter::count>& delta, double flops ) {
+  auto& t = totals[static_cast<std::size_t>( region )];
+  t.calls += 1.0;
+  t.seconds += seconds;
+  t.flops += flops;
+  for ( std::size_t c = 0; c < Counter::count; ++c ) {
+    t.values[c] += static_cast<double>( delta[c] );
+  }
+}
+
+void print( MPI_Comm comm ) {
+  const int rank = getRank( comm );
+
+  // a counter counts only if every rank has it
+  int available[Counter::count], everywhere[Counter::count];
+  for ( std::size_t c = 0; c < Counter::count; ++c ) {
+    available[c] = group.slots[c] >= 0 ? 1 : 0;
+  }
+  MPI_Allreduce( available, everywhere, Counter::count, MPI_INT, MPI_MIN, comm );
+
+  for ( std::size_t r = 0; r < regionCount; ++r ) {
+    auto& t = totals[r];
+    double sums[3 + Counter::count] = { t.calls, t.seconds, t.flops };
+    for ( std::size_t c = 0; c < Counter::count; ++c ) {
+      sums[3 + c] = t.values[c];
+    }
+    const double ipc = t.values[cycles] > 0.0 ? t.values[instructions] / t.values[cycles] : 0.0;
+    double global[3 + Counter::count], maxSeconds = 0.0, minIpc = 0.0, maxIpc = 0.0;
+    MPI_Reduce( sums, global, 3 + Counter::count, MPI_DOUBLE, MPI_SUM, 0, comm );
+    MPI_Reduce( &t.seconds, &maxSeconds, 1, MPI_DOUBLE, MPI_MAX, 0, comm );
+    MPI_Reduce( &ipc, &minIpc, 1, MPI_DOUBLE, MPI_MIN, 0, comm );
+    MPI_Reduce( &ipc, &maxIpc, 1, MPI_DOUBLE, MPI_MAX, 0, comm );
+    t = Totals{};
+
+    if ( rank != 0 || global[0] == 0.0 ) {
+      continue;
+    }
+    std::cout << "Counters region " << regionNames[r]
+              << " calls " << global[0]
+              << " max. time [s] " << maxSeconds;
+    if ( everywhere[cycles] && everywhere[instructions] ) {
+      std::cout << " IPC min/avg/max " << minIpc
+                << " " << global[3 + instructions] / std::max( global[3 + cycles], 1.0 )
+                << " " << maxIpc;
+    }
+    if ( everywhere[loadMisses] ) {
+      double misses = global[3 + loadMisses] + ( everywhere[storeMisses] ? global[3 + storeMisses] : 0.0 );
+      double bytes = misses * lineBytes;
+      std::cout << " LLC misses " << misses
+                << " memory [GB/s] " << ( maxSeconds > 0.0 ? bytes / maxSeconds * 1e-9 : 0.0 );
+      if ( global[2] > 0.0 ) {
+        std::cout << " bytes/flop " << bytes / global[2];
+      }
+    }
+    std::cout << "\n";
+  }
+}
+
+} // namespace counters
@@ -0,0 +1,96 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * Counters.h
+ *
+ *  Created on: Oct 2026
+ *      Author: Gregor Weiss
+ *
+ *  Hardware counters of the compute and copy regions, read with Linux
+ *  perf_event_open around every call. Cycles, instructions and the load and
+ *  store misses of the last level cache are opened as one group per thread;
+ *  a counter the CPU or the kernel does not offer is left out, and without
+ *  any counter a region is timed only. Only the thread that started the
+ *  counters, the main thread, counts its regions.
+ */
+
+#ifndef COUNTERS_H_
+#define COUNTERS_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <mpi.h>
+
+enum class Region : std::size_t { iterate, noghost, store, exchange, count };
+
+constexpr std::size_t regionCount = static_cast<std::size_t>( Region::count );
+
+constexpr std::array<const char*, regionCount> regionNames{
+  "iterate", "data_noghost", "store", "exchange" };
+
+namespace counters {
+
+enum Counter : std::size_t { cycles, instructions, loadMisses, storeMisses, count };
+
+// set by start on the calling thread, read on every region; regions on other
+// threads, e.g. parallelFor workers, are not counted
+extern thread_local bool enabled;
+
+// opens the counters of the calling thread and enables it, returns the names
+// of those that are available or why none is
+std::string start();
+
+// values of the counters of the calling thread, scaled if multiplexed
+std::array<std::uint64_t, Counter::count> read();
+
+// adds a call of a region to the totals of the process, which only the
+// thread that started the counters updates
+void add( Region region, double seconds, const std::array<std::uint64_t, Counter::count>& delta, double flops );
+
+// Rank 0 prints per region the calls, the time, min/avg/max IPC over the
+// ranks, the cache misses, the memory traffic and the bytes per flop, and
+// the totals are reset, collective
+void print( MPI_Comm comm );
+
+} // namespace counters
+
+// Reads the counters around its lifetime; flops: floating point operations
+// of the region, for the bytes per flop
+class CounterScope
+{
+ public:
+  CounterScope( Region region, double flops = 0.0 )
+    : _region{ region }
+    , _flops{ flops } {
+    if ( counters::enabled ) {
+      _begin = counters::read();
+      _time = MPI_Wtime();
+    }
+  }
+
+  ~CounterScope() {
+    if ( counters::enabled ) {
+      const double seconds = MPI_Wtime() - _time;
+      auto delta = counters::read();
+      for ( std::size_t c = 0; c < delta.size(); ++c ) {
+        delta[c] -= _begin[c];
+      }
+      counters::add( _region, seconds, delta, _flops );
+    }
+  }
+
+  CounterScope( CounterScope const& other ) = delete;
+
+  CounterScope& operator=( CounterScope const& other ) = delete;
+
+ private:
+  Region _region;
+  double _flops;
+  std::array<std::uint64_t, counters::Counter::count> _begin{};
+  double _time{ 0.0 };
+};
+
+#endif /* COUNTERS_H_ */
@@ -0,0 +1,116 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * Durability.cpp
+ *
+ *  Created on: Oct 2026
+ *      Author: Gregor Weiss
+ */
+
+#include "Durability.h"
+
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+thread_local double seconds = 0.0;
+
+// adds the lifetime of the object to the sync time of the thread
+class Timer
+{
+ public:
+  Timer() : _begin{ std::chrono::steady_clock::now() } {}
+
+  ~Timer() { seconds += std::chrono::duration<double>( std::chrono::steady_clock::now() - _begin ).count(); }
+
+ private:
+  std::chrono::steady_clock::time_point _begin;
+};
+
+} // namespace
+
+Durability parseDurability( const std::string& name ) {
+  if ( name == "none" || name == "close" ) {
+    return Durability::none;
+  }
+  if ( name == "fdatasync" ) {
+    return Durability::fdatasync;
+  }
+  if ( name == "fsync" ) {
+    return Durability::fsync;
+  }
+  if ( name == "range" ) {
+    return Durability::range;
+  }
+  if ( name == "mpi" ) {
+    return Durability::mpi;
+  }
+  throw std::invalid_argument("Invalid value given for durability: " + name);
+}
+
+void syncChunk( int fd, long long offset, long long length, Durability d ) {
+#ifdef __linux__
+  if ( d != Durability::range ) {
+    return;
+  }
+  Timer timer;
+  sync_file_range( fd, offset, length, SYNC_FILE_RANGE_WRITE );
+#endif
+}
+
+void syncFile( int fd, Durability d ) {
+  if ( d == Durability::none ) {
+    return;
+  }
+  Timer timer;
+  int result = 0;
+#ifdef __linux__
+  if ( d == Durability::range ) {
+    // waits for the writeback started per chunk and writes what is left
+    result = sync_file_range( fd, 0, 0, SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER );
+  } else
+#endif
+  if ( d == Durability::fdatasync || d == Durability::range ) {
+    result = fdatasync( fd );
+  } else {
+    result = fsync( fd );
+  }
+  if ( result != 0 ) {
+    std::cout << "WARNING: sync failed on descriptor " << fd << std::endl;
+  }
+}
+
+void syncFile( const std::string& filename, Durability d ) {
+  if ( d == Durability::none ) {
+    return;
+  }
+  int fd = open( filename.c_str(), O_RDONLY );
+  if ( fd < 0 ) {
+    std::cout << "WARNING: cannot open " << filename << " to sync it" << std::endl;
+    return;
+  }
+  syncFile( fd, d );
+  close( fd );
+}
+
+void syncFile( MPI_File fh, Durability d ) {
+  if ( d == Durability::none ) {
+    return;
+  }
+  Timer timer;
+  MPI_File_sync( fh );
+}
+
+double syncSeconds() {
+  return seconds;
+}
+
+void resetSyncSeconds() {
+  seconds = 0.0;
+}
@@ -0,0 +1,45 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * Durability.h
+ *
+ *  Created on: Oct 2026
+ *      Author: Gregor Weiss
+ *
+ *  How far written data is pushed before a write counts as done, the same
+ *  for all schemes: none (page cache at close), fdatasync, fsync, range
+ *  (sync_file_range per chunk, waited for at the end) or mpi (MPI_File_sync).
+ *  POSIX schemes sync mpi like fsync, the MPI-IO schemes sync every policy
+ *  but none with MPI_File_sync. The time spent is accumulated per thread.
+ */
+
+#ifndef DURABILITY_H_
+#define DURABILITY_H_
+
+#include <string>
+#include <mpi.h>
+
+enum class Durability { none, fdatasync, fsync, range, mpi };
+
+// close is the same as none, throws std::invalid_argument for unknown names
+Durability parseDurability( const std::string& name );
+
+// starts the writeback of a chunk just handed to the kernel, range only
+void syncChunk( int fd, long long offset, long long length, Durability d );
+
+// blocks until the data written to fd is on the device
+void syncFile( int fd, Durability d );
+
+// the same for a file whose descriptor the scheme does not expose
+void syncFile( const std::string& filename, Durability d );
+
+// MPI_File_sync for every policy but none, collective
+void syncFile( MPI_File fh, Durability d );
+
+// seconds this thread spent in the sync functions since the last reset
+double syncSeconds();
+
+void resetSyncSeconds();
+
+#endif /* DURABILITY_H_ */
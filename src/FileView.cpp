@@ -33,7 +33,7 @@ void subarray1D( const Settings& settings, MPI_Datatype& filetype ) {
                        &contiguous_array );
   MPI_Type_commit( &contiguous_array );
   // Create 1D subarray based on the contiguous array
-  int sizes[1] = { static_cast<int>( settings.npx * settings.npy * settings.ndz ) };
+  int sizes[1] = { static_cast<int>( settings.npx * settings.npy * settings.npz ) };
   int subsizes[1] = { 1 };
   int starts[1] = { static_cast<int>( settings.rank ) };
   MPI_Type_create_subarray( 1,
@@ -0,0 +1,86 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * Footprint.cpp
+ *
+ *  Created on: Oct 2026
+ *      Author: Gregor Weiss
+ */
+
+#include "Footprint.h"
+#include "helper.h"
+
+#include <fstream>
+#include <iostream>
+#include <string>
+
+StorageTraffic StorageTraffic::now() {
+  StorageTraffic traffic;
+  std::ifstream in( "/proc/self/io" );
+  std::string key;
+  double value = 0.0;
+  while ( in >> key >> value ) {
+    if ( key == "read_bytes:" ) {
+      traffic.readBytes = value;
+    } else if ( key == "write_bytes:" ) {
+      traffic.writeBytes = value;
+    } else if ( key == "cancelled_write_bytes:" ) {
+      traffic.cancelledBytes = value;
+    }
+  }
+  return traffic;
+}
+
+MemoryFootprint MemoryFootprint::now() {
+  MemoryFootprint memory;
+  memory.peakBytes = PeakResidentBytes();
+  std::ifstream in( "/proc/self/status" );
+  std::string line;
+  while ( std::getline( in, line ) ) {
+    if ( line.rfind( "VmRSS:", 0 ) == 0 ) {
+      // in kB
+      memory.residentBytes = std::stod( line.substr( 6 ) ) * 1024.0;
+      break;
+    }
+  }
+  return memory;
+}
+
+void printTraffic( std::string_view identifier, const StorageTraffic& before,
+                   double payloadBytes, MPI_Comm comm ) {
+  const StorageTraffic local = StorageTraffic::now() - before;
+  double sums[3] = { local.writeBytes, local.readBytes, local.cancelledBytes };
+  double global[3];
+  MPI_Reduce( sums, global, 3, MPI_DOUBLE, MPI_SUM, 0, comm );
+  if ( getRank( comm ) == 0 ) {
+    std::cout << identifier
+              << " device write [GB] " << global[0] * 1e-9
+              << " read [GB] " << global[1] * 1e-9
+              << " cancelled [GB] " << global[2] * 1e-9;
+    if ( payloadBytes > 0.0 ) {
+      std::cout << " of payload [GB] " << payloadBytes * 1e-9;
+    }
+    std::cout << "\n";
+  }
+}
+
+void printMemory( std::string_view identifier, double solverBytes, double ioBytes, MPI_Comm comm ) {
+  const MemoryFootprint local = MemoryFootprint::now();
+  const double mib = 1024.0 * 1024.0;
+  double minRss = 0.0, sumRss = 0.0;
+  double maxima[4] = { local.residentBytes, local.peakBytes, solverBytes, ioBytes };
+  double global[4];
+  MPI_Reduce( &local.residentBytes, &minRss, 1, MPI_DOUBLE, MPI_MIN, 0, comm );
+  MPI_Reduce( &local.residentBytes, &sumRss, 1, MPI_DOUBLE, MPI_SUM, 0, comm );
+  MPI_Reduce( maxima, global, 4, MPI_DOUBLE, MPI_MAX, 0, comm );
+  if ( getRank( comm ) == 0 ) {
+    std::cout << identifier
+              << " RSS min/avg/max [MiB] " << minRss / mib
+              << " " << sumRss / getNProcs( comm ) / mib
+              << " " << global[0] / mib
+              << " max. peak [MiB] " << global[1] / mib
+              << " max. held by solver [MiB] " << global[2] / mib
+              << " by I/O [MiB] " << global[3] / mib << "\n";
+  }
+}
@@ -0,0 +1,55 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * Footprint.h
+ *
+ *  Created on: Oct 2026
+ *      Author: Gregor Weiss
+ *
+ *  Memory of the ranks and the traffic that reached the storage device.
+ *  The storage bytes come from /proc/self/io: a read served by the page cache
+ *  adds nothing to read_bytes, and dirty data removed or truncated before its
+ *  writeback is taken back by cancelled_write_bytes. Network file systems may
+ *  not account there, and where /proc/self/io is missing they stay zero.
+ */
+
+#ifndef FOOTPRINT_H_
+#define FOOTPRINT_H_
+
+#include <string_view>
+#include <mpi.h>
+
+// Storage bytes of the process, all threads included
+struct StorageTraffic
+{
+  double readBytes{ 0.0 };      // fetched from the device
+  double writeBytes{ 0.0 };     // dirtied in the page cache for the device
+  double cancelledBytes{ 0.0 }; // dirty bytes truncated or removed before writeback
+
+  static StorageTraffic now();
+
+  StorageTraffic operator-( const StorageTraffic& other ) const {
+    return { readBytes - other.readBytes, writeBytes - other.writeBytes, cancelledBytes - other.cancelledBytes };
+  }
+};
+
+// Resident set of the process from /proc/self/status, peak from getrusage
+struct MemoryFootprint
+{
+  double residentBytes{ 0.0 };
+  double peakBytes{ 0.0 };
+
+  static MemoryFootprint now();
+};
+
+// Rank 0 prints the storage bytes of all ranks since before and the share
+// of payload bytes that reached the device, collective
+void printTraffic( std::string_view identifier, const StorageTraffic& before,
+                   double payloadBytes, MPI_Comm comm );
+
+// Rank 0 prints min/avg/max of the resident set, the max. peak and the max.
+// bytes held by the solver and the I/O, collective
+void printMemory( std::string_view identifier, double solverBytes, double ioBytes, MPI_Comm comm );
+
+#endif /* FOOTPRINT_H_ */
@@ -0,0 +1,104 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * Generator.cpp
+ *
+ *  Created on: Oct 2026
+ *      Author: Gregor Weiss
+ */
+
+#include "Generator.h"
+#include "helper.h"
+#include "Trace.h"
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+
+namespace {
+
+enum class Pattern { constant, ramp, heat, random };
+
+Pattern parsePattern( const std::string& name ) {
+  if ( name == "constant" ) {
+    return Pattern::constant;
+  }
+  if ( name == "ramp" ) {
+    return Pattern::ramp;
+  }
+  if ( name == "heat" ) {
+    return Pattern::heat;
+  }
+  return Pattern::random;
+}
+
+// counter-based, the value of an index does not depend on the order of generation
+inline std::uint64_t splitmix64( std::uint64_t x ) {
+  x += 0x9e3779b97f4a7c15ull;
+  x = ( x ^ ( x >> 30 ) ) * 0xbf58476d1ce4e5b9ull;
+  x = ( x ^ ( x >> 27 ) ) * 0x94d049bb133111ebull;
+  return x ^ ( x >> 31 );
+}
+
+// profile of the heat field along one dimension of the global array
+std::vector<double> profile( unsigned int n, unsigned int offset, unsigned int global ) {
+  const double pi = 4.0 * std::atan( 1.0 );
+  std::vector<double> values( n );
+  for ( unsigned int i = 0; i < n; ++i ) {
+    values[i] = std::sin( pi * ( offset + i + 0.5 ) / global );
+  }
+  return values;
+}
+
+} // namespace
+
+void generate( const Settings& s, unsigned int step, std::vector<std::vector<double> >& iterations ) {
+  TraceScope scope( "generate", "compute", static_cast<std::uint64_t>( s.ndx ) * s.ndy * s.ndz
+                                           * sizeof( double ) * s.iterations, static_cast<int>( step ) );
+  const size_t plane = static_cast<size_t>( s.ndy ) * s.ndz;
+  iterations.resize( s.iterations );
+  for ( auto& iteration : iterations ) {
+    iteration.resize( plane * s.ndx );
+  }
+
+  const Pattern pattern = parsePattern( s.data );
+  const auto px = profile( s.ndx, s.offsx, s.gndx );
+  const auto py = profile( s.ndy, s.offsy, s.gndy );
+  const auto pz = profile( s.ndz, s.offsz, s.gndz );
+
+  // one task per x plane of an iteration, the inner loops over z vectorize
+  parallelFor( static_cast<size_t>( s.iterations ) * s.ndx, s.threads,
+    [ & ]( size_t n )
+    {
+      const size_t it = n / s.ndx;
+      const unsigned int i = static_cast<unsigned int>( n % s.ndx );
+      const std::uint64_t time = static_cast<std::uint64_t>( step - 1 ) * s.iterations + it;
+      double* __restrict out = iterations[it].data() + i * plane;
+
+      for ( unsigned int j = 0; j < s.ndy; ++j ) {
+        double* __restrict row = out + static_cast<size_t>( j ) * s.ndz;
+        const std::uint64_t first = ( static_cast<std::uint64_t>( s.offsx + i ) * s.gndy + s.offsy + j ) * s.gndz + s.offsz;
+        if ( pattern == Pattern::constant ) {
+          for ( unsigned int k = 0; k < s.ndz; ++k ) {
+            row[k] = 1.0;
+          }
+        } else if ( pattern == Pattern::ramp ) {
+          const double base = static_cast<double>( first + time );
+          for ( unsigned int k = 0; k < s.ndz; ++k ) {
+            row[k] = base + k;
+          }
+        } else if ( pattern == Pattern::heat ) {
+          const double amplitude = 10.0 * std::exp( -0.01 * static_cast<double>( time ) ) * px[i] * py[j];
+          for ( unsigned int k = 0; k < s.ndz; ++k ) {
+            row[k] = amplitude * pz[k];
+          }
+        } else {
+          const std::uint64_t key = splitmix64( s.seed ^ splitmix64( time ) );
+          for ( unsigned int k = 0; k < s.ndz; ++k ) {
+            row[k] = static_cast<double>( splitmix64( key + first + k ) >> 11 ) * 0x1.0p-53;
+          }
+        }
+      }
+    } );
+}
@@ -0,0 +1,28 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * Generator.h
+ *
+ *  Created on: Oct 2026
+ *      Author: Gregor Weiss
+ *
+ *  Synthetic iterations for I/O-only runs instead of the stencil: every value
+ *  is a function of its global index and the iteration, so the data does not
+ *  depend on the decomposition or the number of threads.
+ */
+
+#ifndef GENERATOR_H_
+#define GENERATOR_H_
+
+#include "Settings.h"
+
+#include <vector>
+
+// fills settings.iterations iterations of step with the pattern settings.data:
+// constant, ramp (global index plus iteration), heat (smooth field decaying
+// over the iterations) or random (uniform in [0, 1) from settings.seed),
+// reuses the buffers of the previous step
+void generate( const Settings& s, unsigned int step, std::vector<std::vector<double> >& iterations );
+
+#endif /* GENERATOR_H_ */
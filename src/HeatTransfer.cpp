@@ -11,6 +11,7 @@
  *
  */
 
+#include <cstdint>
 #include <cstring>
 
 #include <algorithm>
@@ -23,7 +24,9 @@
 
 //#include "ndarray.h"
 
+#include "Counters.h"
 #include "HeatTransfer.h"
+#include "Trace.h"
 
 HeatTransfer::HeatTransfer(const Settings &settings)
 : m_s(settings),
@@ -94,6 +97,9 @@ void HeatTransfer::printT(std::string message, MPI_Comm comm) const
 
 void HeatTransfer::iterate()
 {
+    TraceScope scope("iterate", "compute", sizeof(double) * m_s.ndx * m_s.ndy * m_s.ndz);
+    // five additions for the neighbours, two multiplications and an addition per point
+    CounterScope counted(Region::iterate, 8.0 * m_s.ndx * m_s.ndy * m_s.ndz);
     for (unsigned int i = 1; i <= m_s.ndx; ++i)
     {
         for (unsigned int j = 1; j <= m_s.ndy; ++j)
@@ -113,6 +119,16 @@ void HeatTransfer::iterate()
 
 void HeatTransfer::exchange(MPI_Comm comm)
 {
+    // bytes sent, one face to every neighbour
+    const std::uint64_t faceX = sizeof(double) * (m_s.ndy + 2) * (m_s.ndz + 2);
+    const std::uint64_t faceY = sizeof(double) * (m_s.ndx + 2) * (m_s.ndz + 2);
+    const std::uint64_t faceZ = sizeof(double) * (m_s.ndx + 2) * (m_s.ndy + 2);
+    TraceScope scope("exchange", "exchange",
+                     faceY * ((m_s.rank_left >= 0) + (m_s.rank_right >= 0)) +
+                     faceX * ((m_s.rank_up >= 0) + (m_s.rank_down >= 0)) +
+                     faceZ * ((m_s.rank_front >= 0) + (m_s.rank_back >= 0)));
+    CounterScope counted(Region::exchange);
+
     // Build a custom MPI type for the column vector to allow strided access
     MPI_Datatype tColumnVector;
     MPI_Type_vector(m_s.ndx + 2, 1, m_s.ndy + 2, MPI_REAL8, &tColumnVector);
@@ -231,6 +247,7 @@ void HeatTransfer::exchange(MPI_Comm comm)
  */
 std::vector<double> HeatTransfer::data_noghost() const
 {
+    CounterScope counted(Region::noghost);
     std::vector<double> d(m_s.ndx * m_s.ndy * m_s.ndz);
     for (unsigned int i = 1; i <= m_s.ndx; ++i)
     {
@@ -240,11 +257,23 @@ std::vector<double> HeatTransfer::data_noghost() const
     return d;
 }
 
+double HeatTransfer::heldBytes() const
+{
+    double bytes = 2.0 * sizeof(double) * (m_s.ndx + 2) * (m_s.ndy + 2) * (m_s.ndz + 2);
+    for (const auto& iteration : m_TIterations)
+    {
+        bytes += static_cast<double>(iteration.capacity() * sizeof(double));
+    }
+    return bytes;
+}
+
 /* Copies the iteration into a separate public vector
  * of vectors that is publicly available.
  */
 void HeatTransfer::store()
 {
+    TraceScope scope("store", "compute", sizeof(double) * m_s.ndx * m_s.ndy * m_s.ndz);
+    CounterScope counted(Region::store);
     auto TIteration = data_noghost();
     m_TIterations.push_back( TIteration );
 }
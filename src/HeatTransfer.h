@@ -37,6 +37,8 @@ public:
     // return (1D) pointer to current T data without ghost cells, ndx*ndy elements
     std::vector<double> data_noghost() const;
     void store();
+    // bytes of the two fields and the stored iterations
+    double heldBytes() const;
 
     void printT(std::string message,
                 MPI_Comm comm) const; // debug: print local TCurrent on stdout
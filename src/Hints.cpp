@@ -0,0 +1,74 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * Hints.cpp
+ *
+ *  Created on: Oct 2026
+ *      Author: Gregor Weiss
+ */
+
+#include "Hints.h"
+
+#include <stdexcept>
+
+MPIInfo::MPIInfo( const Hints& hints ) {
+  if ( hints.empty() ) {
+    return;
+  }
+  MPI_Info_create( &_info );
+  for ( const auto& [ key, value ] : hints ) {
+    MPI_Info_set( _info, key.c_str(), value.c_str() );
+  }
+}
+
+MPIInfo::~MPIInfo() {
+  if ( _info != MPI_INFO_NULL ) {
+    MPI_Info_free( &_info );
+  }
+}
+
+Hints parseHints( const std::string& value ) {
+  Hints hints;
+  if ( value == "none" ) {
+    return hints;
+  }
+  size_t begin = 0;
+  for ( ;; ) {
+    const size_t end = value.find( ',', begin );
+    const std::string hint = value.substr( begin, end - begin );
+    const size_t pos = hint.find( '=' );
+    if ( pos == std::string::npos || pos == 0 ) {
+      throw std::invalid_argument("Invalid hint given: " + hint);
+    }
+    hints.emplace_back( hint.substr( 0, pos ), hint.substr( pos + 1 ) );
+    if ( end == std::string::npos ) {
+      return hints;
+    }
+    begin = end + 1;
+  }
+}
+
+std::string toString( const Hints& hints ) {
+  if ( hints.empty() ) {
+    return "none";
+  }
+  std::string joined;
+  for ( const auto& [ key, value ] : hints ) {
+    if ( !joined.empty() ) {
+      joined += ",";
+    }
+    joined += key + "=" + value;
+  }
+  return joined;
+}
+
+void setHint( Hints& hints, const std::string& key, const std::string& value ) {
+  for ( auto& hint : hints ) {
+    if ( hint.first == key ) {
+      hint.second = value;
+      return;
+    }
+  }
+  hints.emplace_back( key, value );
+}
@@ -0,0 +1,49 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * Hints.h
+ *
+ *  Created on: Oct 2026
+ *      Author: Gregor Weiss
+ *
+ *  MPI-IO hints of the settings as MPI_Info for MPI_File_open, the same
+ *  key=value lists serve as ADIOS2 engine parameters.
+ */
+
+#ifndef HINTS_H_
+#define HINTS_H_
+
+#include "Settings.h"
+
+#include <string>
+#include <mpi.h>
+
+class MPIInfo
+{
+ public:
+  // MPI_INFO_NULL if there are no hints
+  explicit MPIInfo( const Hints& hints );
+
+  ~MPIInfo();
+
+  MPIInfo( MPIInfo const& other ) = delete;
+
+  MPIInfo& operator=( MPIInfo const& other ) = delete;
+
+  MPI_Info get() const { return _info; }
+
+ private:
+  MPI_Info _info{ MPI_INFO_NULL };
+};
+
+// "key=value,key=value" or "none", throws std::invalid_argument
+Hints parseHints( const std::string& value );
+
+// "key=value,key=value" or "none"
+std::string toString( const Hints& hints );
+
+// replaces the value of key or appends it
+void setHint( Hints& hints, const std::string& key, const std::string& value );
+
+#endif /* HINTS_H_ */
@@ -10,6 +10,7 @@
 
 #include "IOadios2.h"
 #include "IOascii.h"
+#include "IOmdtest.h"
 #include "IObinary.h"
 #include "IOmpiLevel0.h"
 #include "IOmpiLevel1.h"
@@ -17,10 +18,13 @@
 #ifdef HAVE_SIONLIB
   #include "IOsion.h"
 #endif
+#include "IOshmstage.h"
 #include "IOstream.h"
+#include "helper.h"
 
 using IOVariant = std::variant<IOadios2,
                                IOascii,
+                               IOmdtest,
                                IObinary,
                                IOmpiLevel0,
                                IOmpiLevel1,
@@ -28,6 +32,7 @@ using IOVariant = std::variant<IOadios2,
 #ifdef HAVE_SIONLIB
                                IOsion,
 #endif
+                               IOshmstage,
                                IOstream>;
 
 struct Format
@@ -39,6 +44,8 @@ struct Format
     { return IOascii{ s, comm }; }
     else if ( ioFormat.find( "binary" ) != std::string::npos )
     { return IObinary{ s, comm }; }
+    else if ( ioFormat.compare( "mdtest" ) == 0 )
+    { return IOmdtest{ s, comm }; }
     else if ( ioFormat.compare( "level0" ) == 0 )
     { return IOmpiLevel0{ s, comm }; }
     else if ( ioFormat.compare( "level1" ) == 0 )
@@ -49,6 +56,8 @@ struct Format
     else if ( ioFormat.compare( "sion" ) == 0 )
     { return IOsion{ s, comm }; }
 #endif
+    else if ( ioFormat.compare( "shmstage" ) == 0 )
+    { return IOshmstage{ s, comm }; }
     else if ( ioFormat.compare( "stream" ) == 0 )
     { return IOstream{ s, comm }; }
     
@@ -56,46 +65,175 @@ struct Format
   };
 };
 
-template<typename IOStrategy>
-IO<IOStrategy>::IO( const Settings& settings, MPI_Comm communicator )
+template<typename IOStrategy, typename Policy>
+IO<IOStrategy, Policy>::IO( const Settings& settings, MPI_Comm communicator )
   : _settings{ settings }
-  , _communicator{ communicator } {}
+  , _communicator{ communicator }
+  , _callerCommunicator{ communicator } {
+  // with a burst buffer the scheme writes from the drain thread on its own communicator
+  if ( !_settings.stage.empty() ) {
+    MPI_Comm_dup( communicator, &_communicator );
+    _ownsCommunicator = true;
+  }
+}
+
+template<typename IOStrategy, typename Policy>
+IO<IOStrategy, Policy>::~IO() {
+  _burstBuffer.reset();
+  _removal.reset();
+  if ( _ownsCommunicator ) {
+    MPI_Comm_free( &_communicator );
+  }
+}
 
-template<typename IOStrategy>
-void IO<IOStrategy>::chooseFormat( std::string ioFormat ) {
+template<typename IOStrategy, typename Policy>
+void IO<IOStrategy, Policy>::chooseFormat( std::string ioFormat ) {
   std::optional<IOStrategy> newFormat = Format{}( _settings, _communicator, ioFormat );
   if ( newFormat )
   { _ioFormat = std::move( *newFormat ); }
 }
 
-template<typename IOStrategy>
-void IO<IOStrategy>::write( int step,
+template<typename IOStrategy, typename Policy>
+void IO<IOStrategy, Policy>::write( int step,
                             const HeatTransfer& ht,
                             const Settings& s,
                             MPI_Comm comm ) {
+  TraceScope scope( "write", "io", static_cast<std::uint64_t>( s.ndx ) * s.ndy * s.ndz
+                                  * sizeof( double ) * ht.m_TIterations.size(), step );
+  recorder<Policy>().reset();
+  resetSyncSeconds();
+  PhaseClock<Policy> clock;
+
+  if ( !_settings.stage.empty() ) {
+    // created on the first write, so that a reading instance starts no drain thread
+    if ( !_burstBuffer ) {
+      _burstBuffer = std::make_unique<BurstBuffer>( _settings, _communicator,
+        [ this ]( int stagedStep, const std::vector<std::vector<double> >& staged )
+        {
+          std::visit(
+            [ this, &stagedStep, &staged ]( auto& ioFormat )
+            {
+              // ascii prints the solver's field and is rejected with stage=
+              if constexpr ( requires { ioFormat.write( stagedStep, staged, _settings, _communicator ); } ) {
+                ioFormat.write( stagedStep, staged, _settings, _communicator );
+              }
+            }, _ioFormat
+          );
+        } );
+    }
+    _burstBuffer->stage( step, ht, comm );
+    clock.lap( Phase::total );
+    return;
+  }
+
   std::visit(
     [ &step, &ht, &s, &comm ]( auto& ioFormat )
     {
       ioFormat.write( step, ht, s, comm );
     }, _ioFormat
   );
+  clock.lap( Phase::total );
 }
 
-template<typename IOStrategy>
-void IO<IOStrategy>::read( const int step,
+template<typename IOStrategy, typename Policy>
+void IO<IOStrategy, Policy>::read( const int step,
                            std::vector<std::vector<double> >& buffer,
                            const Settings& s,
                            MPI_Comm comm ) {
+  TraceScope scope( "read", "io", static_cast<std::uint64_t>( s.ndx ) * s.ndy * s.ndz
+                                 * sizeof( double ) * s.iterations, step );
+  recorder<Policy>().reset();
+  PhaseClock<Policy> clock;
   std::visit(
     [ &step, &buffer, &s, &comm ]( auto& ioFormat )
     {
       ioFormat.read( step, buffer, s, comm );
     }, _ioFormat
   );
+  clock.lap( Phase::total );
 }
 
-template<typename IOStrategy>
-void IO<IOStrategy>::remove( const int step ) {
+template<typename IOStrategy, typename Policy>
+void IO<IOStrategy, Policy>::openStep( int step, const Settings& s, MPI_Comm comm ) {
+  TraceScope scope( "openStep", "io", 0, step );
+  recorder<Policy>().reset();
+  resetSyncSeconds();
+  PhaseClock<Policy> clock;
+  _openStep = step;
+  // Settings rejects the other schemes and compression
+  std::visit(
+    [ &step, &s, &comm ]( auto& ioFormat )
+    {
+      if constexpr ( requires { ioFormat.openStep( step, s, comm ); } ) {
+        ioFormat.openStep( step, s, comm );
+      } else {
+        throw std::logic_error( "IO::openStep: the scheme cannot stream" );
+      }
+    }, _ioFormat
+  );
+  clock.lap( Phase::total );
+}
+
+template<typename IOStrategy, typename Policy>
+void IO<IOStrategy, Policy>::putIteration( const std::vector<double>& iteration,
+                                           const Settings& s,
+                                           MPI_Comm comm ) {
+  TraceScope scope( "putIteration", "io", iteration.size() * sizeof( double ), _openStep );
+  PhaseClock<Policy> clock;
+  std::visit(
+    [ &iteration, &s, &comm ]( auto& ioFormat )
+    {
+      if constexpr ( requires { ioFormat.putIteration( iteration, s, comm ); } ) {
+        ioFormat.putIteration( iteration, s, comm );
+      }
+    }, _ioFormat
+  );
+  clock.lap( Phase::total );
+}
+
+template<typename IOStrategy, typename Policy>
+void IO<IOStrategy, Policy>::closeStep( const Settings& s, MPI_Comm comm ) {
+  TraceScope scope( "closeStep", "io", 0, _openStep );
+  PhaseClock<Policy> clock;
+  std::visit(
+    [ &s, &comm ]( auto& ioFormat )
+    {
+      if constexpr ( requires { ioFormat.closeStep( s, comm ); } ) {
+        ioFormat.closeStep( s, comm );
+      }
+    }, _ioFormat
+  );
+  clock.lap( Phase::total );
+}
+
+template<typename IOStrategy, typename Policy>
+void IO<IOStrategy, Policy>::remove( const int step ) {
+  wait( step );
+  TraceScope scope( "remove", "io", 0, step );
+  if ( _settings.keep > 0 || _settings.asyncRemove ) {
+    bool queued = std::visit(
+      [ this, &step ]( auto& ioFormat )
+      {
+        if constexpr ( requires { ioFormat.stepFiles( step, _settings ); } ) {
+          using Format = std::decay_t<decltype( ioFormat )>;
+          constexpr bool perRank = std::is_same_v<Format, IObinary> || std::is_same_v<Format, IOstream>;
+          if ( !_removal ) {
+            _removal = std::make_unique<RemovalService>( _callerCommunicator, _settings.asyncRemove );
+          }
+          // a shared step is listed by rank 0 only
+          const bool lists = perRank || getRank( _callerCommunicator ) == 0;
+          _removal->enqueue( step, lists ? ioFormat.stepFiles( step, _settings ) : std::vector<std::string>{},
+                             !perRank, _settings.outputfile );
+          return true;
+        }
+        return false;
+      }, _ioFormat
+    );
+    if ( queued ) {
+      return;
+    }
+  }
+
   std::visit(
     [ &step ]( auto& ioFormat )
     {
@@ -104,3 +242,76 @@ void IO<IOStrategy>::remove( const int step ) {
   );
 }
 
+template<typename IOStrategy, typename Policy>
+void IO<IOStrategy, Policy>::evict( const int step ) {
+  TraceScope scope( "evict", "io", 0, step );
+  std::visit(
+    [ this, &step ]( auto& ioFormat )
+    {
+      if constexpr ( requires { ioFormat.stepFiles( step, _settings ); } ) {
+        for ( const auto& filename : ioFormat.stepFiles( step, _settings ) )
+        { EvictFromCache( filename ); }
+      }
+    }, _ioFormat
+  );
+}
+
+template<typename IOStrategy, typename Policy>
+void IO<IOStrategy, Policy>::prefetch( const int step ) {
+  TraceScope scope( "prefetch", "io", 0, step );
+  std::visit(
+    [ this, &step ]( auto& ioFormat )
+    {
+      if constexpr ( requires { ioFormat.stepFiles( step, _settings ); } ) {
+        for ( const auto& filename : ioFormat.stepFiles( step, _settings ) )
+        { AdviseWillNeed( filename ); }
+      }
+    }, _ioFormat
+  );
+}
+
+template<typename IOStrategy, typename Policy>
+RemovalService::Report IO<IOStrategy, Policy>::flushRemovals() {
+  if ( _removal ) {
+    return _removal->flush();
+  }
+  return {};
+}
+
+template<typename IOStrategy, typename Policy>
+void IO<IOStrategy, Policy>::wait( const int step ) {
+  if ( _burstBuffer ) {
+    _burstBuffer->wait( step );
+  }
+}
+
+template<typename IOStrategy, typename Policy>
+double IO<IOStrategy, Policy>::heldBytes() {
+  double bytes = std::visit(
+    []( auto& ioFormat )
+    {
+      if constexpr ( requires { ioFormat.heldBytes(); } ) {
+        return ioFormat.heldBytes();
+      }
+      return 0.0;
+    }, _ioFormat
+  );
+  if ( _burstBuffer ) {
+    bytes += _burstBuffer->heldBytes();
+  }
+  return bytes;
+}
+
+template<typename IOStrategy, typename Policy>
+CompressionStage* IO<IOStrategy, Policy>::compression() {
+  return std::visit(
+    []( auto& ioFormat ) -> CompressionStage*
+    {
+      if constexpr ( requires { ioFormat.compression(); } ) {
+        if ( ioFormat.compression().enabled() )
+        { return &ioFormat.compression(); }
+      }
+      return nullptr;
+    }, _ioFormat
+  );
+}
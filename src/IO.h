@@ -14,27 +14,44 @@
 #ifndef IO_H_
 #define IO_H_
 
+#include "BurstBuffer.h"
+#include "Compression.h"
+#include "Durability.h"
 #include "HeatTransfer.h"
+#include "Instrumentation.h"
+#include "Removal.h"
 #include "Settings.h"
+#include "Trace.h"
 
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <cstdio>
 
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
 #include <variant>
 #include <optional>
 
 #include <vector>
 #include <mpi.h>
 
-template<typename IOStrategy>
+// Policy: recorder of the phase timers, see Instrumentation.h
+template<typename IOStrategy, typename Policy = Recorder>
 class IO
 {
  public:
   IO() = default;
   
   IO( const Settings& settings, MPI_Comm communicator );
+
+  ~IO();
+
+  // the drain of the burst buffer refers to this object
+  IO( IO const& other ) = delete;
+
+  IO& operator=( IO const& other ) = delete;
   
   void chooseFormat( std::string ioFormat );
   
@@ -47,13 +64,46 @@ class IO
              std::vector<std::vector<double> >& buffer,
              const Settings& s,
              MPI_Comm comm );
+
+  // streaming: the iterations of step are handed over one at a time and end
+  // up in the layout of write, for the schemes with openStep, uncompressed
+  void openStep( int step, const Settings& s, MPI_Comm comm );
+
+  void putIteration( const std::vector<double>& iteration, const Settings& s, MPI_Comm comm );
+
+  void closeStep( const Settings& s, MPI_Comm comm );
   
+  // with keep= or removal=async the files of step are striped over the
+  // ranks and removed by the removal service
   void remove( const int step );
+
+  // blocks until all removals are done, the local report of the removal service
+  RemovalService::Report flushRemovals();
+
+  // compression stage of the chosen format, nullptr if it has none or it is disabled
+  CompressionStage* compression();
+
+  // drops the files of step from the page cache, for cold reads
+  void evict( const int step );
+
+  // asks the kernel to read the files of step ahead
+  void prefetch( const int step );
+
+  // blocks until a step staged on the burst buffer is in the final target
+  void wait( const int step );
+
+  // bytes held by the scheme and the burst buffer
+  double heldBytes();
  
  private:
   const Settings _settings;
   MPI_Comm _communicator;
+  MPI_Comm _callerCommunicator; // of the calling thread, _communicator belongs to the drain with stage=
+  bool _ownsCommunicator{ false };
   IOStrategy _ioFormat;
+  std::unique_ptr<BurstBuffer> _burstBuffer{};
+  std::unique_ptr<RemovalService> _removal{};
+  int _openStep{ 0 };
 };
 
 #include "IO.cpp"
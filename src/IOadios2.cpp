@@ -9,9 +9,13 @@
  */
 
 #include "IOadios2.h"
+#include "Durability.h"
+#include "Instrumentation.h"
 #include "helper.h"
 
+#include <algorithm>
 #include <filesystem>
+#include <stdexcept>
 
 IOadios2::IOadios2( const Settings& settings, MPI_Comm communicator )
   : _adios2Component{ std::make_unique<adios2::ADIOS>( settings.configfile, communicator ) }
@@ -21,22 +25,71 @@ IOadios2::IOadios2( const Settings& settings, MPI_Comm communicator )
   , _inputVariable{}
   , _communicator{ communicator }
   , _outputfilename{ settings.outputfile }
-  , _rank{ getRank( _communicator ) } {}
+  , _rank{ getRank( _communicator ) } {
+  if ( !settings.parameters.empty() ) {
+    const adios2::Params parameters( settings.parameters.begin(), settings.parameters.end() );
+    _ioOutput.SetParameters( parameters );
+    _ioInput.SetParameters( parameters );
+  }
+}
 
 void IOadios2::write( int step,
                       const HeatTransfer& ht,
                       const Settings& s,
                       MPI_Comm comm ) {
+  write( step, ht.m_TIterations, s, comm );
+}
+
+void IOadios2::write( int step,
+                      const std::vector<std::vector<double> >& iterations,
+                      const Settings& s,
+                      MPI_Comm comm ) {
+  openStep( step, s, comm );
+  for ( const auto& iteration : iterations ) {
+    putIteration( iteration, s, comm );
+  }
+  closeStep( s, comm );
+}
+
+void IOadios2::openStep( int step, const Settings& s, MPI_Comm comm ) {
+  PhaseClock<> clock;
+  _step = step;
   _outputfilename = MakeFilename( s.outputfile, ".bp", -1, step );
   _engineWriter = _ioOutput.Open( _outputfilename, adios2::Mode::Write, _communicator );
-  
-  for ( const auto& iteration : ht.m_TIterations ) {
-    _engineWriter.BeginStep();
-    _engineWriter.Put<double>( _outputVariable, iteration.data() );
-    _engineWriter.EndStep();
-  }
-  
+  clock.lap( Phase::open );
+}
+
+void IOadios2::putIteration( const std::vector<double>& iteration, const Settings& s, MPI_Comm comm ) {
+  PhaseClock<> clock;
+  _engineWriter.BeginStep();
+  _engineWriter.Put<double>( _outputVariable, iteration.data() );
+  _engineWriter.EndStep();
+  clock.lap( Phase::transfer );
+}
+
+void IOadios2::closeStep( const Settings& s, MPI_Comm comm ) {
+  PhaseClock<> clock;
   _engineWriter.Close();
+  clock.lap( Phase::close );
+
+  // the engine does not expose which rank wrote which subfile, and a sync
+  // only flushes the pages cached on the node it runs on: every node syncs
+  // all files of the step after the close, striped over its ranks, from the
+  // listing of rank 0
+  const Durability durability = parseDurability( s.durability );
+  if ( durability != Durability::none ) {
+    const auto files = BroadcastNames( _rank == 0 ? stepFiles( _step, s ) : std::vector<std::string>{},
+                                       _communicator );
+    MPI_Comm node;
+    MPI_Comm_split_type( _communicator, MPI_COMM_TYPE_SHARED, _rank, MPI_INFO_NULL, &node );
+    const auto local = static_cast<size_t>( getRank( node ) );
+    const auto nlocal = static_cast<size_t>( getNProcs( node ) );
+    MPI_Comm_free( &node );
+    for ( size_t i = local; i < files.size(); i += nlocal ) {
+      syncFile( files[i], durability );
+    }
+  }
+  clock.lap( Phase::sync );
 }
 
 void IOadios2::read( const int step,
@@ -44,19 +97,52 @@ void IOadios2::read( const int step,
                      const Settings& s,
                      MPI_Comm comm ) {
   auto inputfilename = MakeFilename( s.outputfile, ".bp", -1, step );
+  PhaseClock<> clock;
   _engineReader = _ioInput.Open( inputfilename, adios2::Mode::Read, _communicator );
+  clock.lap( Phase::open );
 
   for ( auto& iteration : buffer ) {
     _engineReader.BeginStep();
     _inputVariable = _ioInput.InquireVariable<double>( "T" );
-    auto blocksInfo = _engineReader.BlocksInfo( _inputVariable, _engineReader.CurrentStep() );
-    auto& info = blocksInfo[_rank];
-    _inputVariable.SetBlockSelection( info.BlockID );
+    if ( s.boxSelection || s.restart ) {
+      // Select this reader's own subdomain from the global array,
+      // independent of how many writers produced the blocks
+      _inputVariable.SetSelection( { { s.offsx, s.offsy, s.offsz },
+                                     { s.ndx, s.ndy, s.ndz } } );
+    } else {
+      auto blocksInfo = _engineReader.BlocksInfo( _inputVariable, _engineReader.CurrentStep() );
+      if ( blocksInfo.size() != s.nproc ) {
+        throw std::runtime_error( "IOadios2::read: " + std::to_string( blocksInfo.size() )
+                                  + " blocks written but " + std::to_string( s.nproc )
+                                  + " readers; use selection=box" );
+      }
+      auto& info = blocksInfo[_rank];
+      _inputVariable.SetBlockSelection( info.BlockID );
+    }
     _engineReader.Get( _inputVariable, iteration.data() );
     _engineReader.EndStep();
   }
+  clock.lap( Phase::transfer );
 
   _engineReader.Close();
+  clock.lap( Phase::close );
+}
+
+// the data and metadata files of the step, BP4 and BP5 store a directory
+std::vector<std::string> IOadios2::stepFiles( const int step, const Settings& s ) const {
+  std::filesystem::path path{ MakeFilename( s.outputfile, ".bp", -1, step ) };
+  if ( !std::filesystem::is_directory( path ) ) {
+    return { path.string() };
+  }
+  std::vector<std::string> files;
+  for ( const auto& entry : std::filesystem::recursive_directory_iterator( path ) ) {
+    if ( entry.is_regular_file() ) {
+      files.push_back( entry.path().string() );
+    }
+  }
+  // the order of the directory iterator is unspecified
+  std::sort( files.begin(), files.end() );
+  return files;
 }
 
 void IOadios2::remove( const int step ) {
@@ -89,10 +175,11 @@ adios2::Variable<double>& IOadios2::defineVariableBySettings( adios2::Variable<d
                                                               adios2::IO& ioComponent,
                                                               std::string identifier,
                                                               const Settings& settings ) {
+  // x is the slowest running dimension of the local arrays, see HeatTransfer::data_noghost
   retVariable = ioComponent.DefineVariable<double>( identifier,
-                                                    { settings.gndz, settings.gndy, settings.gndx },   // global dimensions
-                                                    { settings.offsz, settings.offsy, settings.offsx }, // global offset
-                                                    { settings.ndz, settings.ndy, settings.ndx } );   // local size
+                                                    { settings.gndx, settings.gndy, settings.gndz },   // global dimensions
+                                                    { settings.offsx, settings.offsy, settings.offsz }, // global offset
+                                                    { settings.ndx, settings.ndy, settings.ndz } );   // local size
   return retVariable;
 }
 
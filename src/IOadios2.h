@@ -16,6 +16,7 @@
 
 #include "helper.h"
 
+#include <string>
 #include <vector>
 #include <mpi.h>
 #include <adios2.h>
@@ -51,6 +52,7 @@ class IOadios2
     swap( _inputVariable, other._inputVariable );
     swap( _communicator, other._communicator );
     swap( _outputfilename, other._outputfilename );
+    swap( _step, other._step );
     swap( _rank, other._rank );
   }
   
@@ -58,6 +60,19 @@ class IOadios2
               const HeatTransfer& ht,
               const Settings& s,
               MPI_Comm comm );
+
+  // the iterations without the solver, e.g. from the drain of a burst buffer
+  void write( int step,
+              const std::vector<std::vector<double> >& iterations,
+              const Settings& s,
+              MPI_Comm comm );
+
+  // streaming: the iterations of a step one at a time, an engine step each like write
+  void openStep( int step, const Settings& s, MPI_Comm comm );
+
+  void putIteration( const std::vector<double>& iteration, const Settings& s, MPI_Comm comm );
+
+  void closeStep( const Settings& s, MPI_Comm comm );
   
   void read( const int step,
              std::vector<std::vector<double> >& buffer,
@@ -65,6 +80,9 @@ class IOadios2
              MPI_Comm comm );
   
   void remove( const int step );
+
+  // files this rank reads of step
+  std::vector<std::string> stepFiles( const int step, const Settings& s ) const;
  
  private:
   
@@ -105,6 +123,7 @@ class IOadios2
   MPI_Comm _communicator;
   std::string _outputfilename;
   std::string _configfilename;
+  int _step{ 0 }; // the open step
   int _rank;
   
 };
@@ -9,6 +9,7 @@
  */
 
 #include "IOascii.h"
+#include "Durability.h"
 #include "helper.h"
 
 #include <iomanip>
@@ -59,6 +60,7 @@ void IOascii::write( int step,
   }
   
   _of.close();
+  syncFile( m_outputfilename, parseDurability( s.durability ) );
 }
 
 void IOascii::read( const int step,
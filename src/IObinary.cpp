@@ -9,16 +9,23 @@
  */
 
 #include "IObinary.h"
+#include "Durability.h"
+#include "Instrumentation.h"
+#include "Restart.h"
 #include "helper.h"
 
 #include <cstdio>
 
 #include <filesystem>
 
-IObinary::IObinary( const Settings& s, MPI_Comm comm ) {
+#include <fcntl.h>
+#include <unistd.h>
+
+IObinary::IObinary( const Settings& s, MPI_Comm comm )
+  : _compression{ s, comm } {
   if ( s.format.find("_with_folders") != std::string::npos ) {
     auto rank = getRank( MPI_COMM_WORLD );
-    std::string foldername = MakeProcFolders( rank );
+    std::string foldername = MakeProcFolders( rank, s.layout, comm );
     m_outputfilename = foldername + s.outputfile;
   } else {
     m_outputfilename = s.outputfile;
@@ -29,32 +36,151 @@ void IObinary::write( int step,
                       const HeatTransfer& ht,
                       const Settings& s,
                       MPI_Comm comm ) {
+  write( step, ht.m_TIterations, s, comm );
+}
+
+void IObinary::write( int step,
+                      const std::vector<std::vector<double> >& iterations,
+                      const Settings& s,
+                      MPI_Comm comm ) {
+  openStep( step, s, comm );
+
+  // compression overlaps the writes of the blocks
+  if ( _compression.enabled() ) {
+    PhaseClock<> clock;
+    _compression.encode( iterations,
+                         [ this ]( const char* data, size_t bytes ) { writeChunk( data, bytes ); } );
+    clock.lap( Phase::transfer );
+  } else {
+    for ( const auto& iteration : iterations ) {
+      putIteration( iteration, s, comm );
+    }
+  }
+
+  closeStep( s, comm );
+}
+
+void IObinary::openStep( int step, const Settings& s, MPI_Comm comm ) {
+  PhaseClock<> clock;
+  _durability = parseDurability( s.durability );
   auto filename = MakeFilename( m_outputfilename, ".dat", s.rank, step );
   _filestream.open( filename, std::ios_base::out );
-  
-  auto write_size = static_cast<std::streamsize>( s.ndx * s.ndy * s.ndz * sizeof( double ) );
-  for ( const auto& iteration : ht.m_TIterations ) {
-    _filestream.write( reinterpret_cast<const char*>(iteration.data()),
-                       write_size );
+  // the stream does not expose its descriptor, a second one syncs the same file
+  _fd = _durability == Durability::none ? -1 : ::open( filename.c_str(), O_RDONLY );
+  _offset = 0;
+  clock.lap( Phase::open );
+}
+
+void IObinary::putIteration( const std::vector<double>& iteration, const Settings& s, MPI_Comm comm ) {
+  PhaseClock<> clock;
+  writeChunk( reinterpret_cast<const char*>( iteration.data() ),
+              static_cast<size_t>( s.ndx ) * s.ndy * s.ndz * sizeof( double ) );
+  clock.lap( Phase::transfer );
+}
+
+void IObinary::closeStep( const Settings& s, MPI_Comm comm ) {
+  PhaseClock<> clock;
+  if ( _fd >= 0 ) {
+    _filestream.flush();
+    syncFile( _fd, _durability );
+    ::close( _fd );
+    _fd = -1;
   }
-  
+  clock.lap( Phase::sync );
   _filestream.close();
+  clock.lap( Phase::close );
+}
+
+void IObinary::writeChunk( const char* data, size_t bytes ) {
+  _filestream.write( data, static_cast<std::streamsize>( bytes ) );
+  if ( _durability == Durability::range && _fd >= 0 ) {
+    _filestream.flush();
+    syncChunk( _fd, _offset, static_cast<long long>( bytes ), _durability );
+  }
+  _offset += static_cast<long long>( bytes );
 }
 
 void IObinary::read( const int step,
                      std::vector<std::vector<double> >& buffer,
                      const Settings& s,
                      MPI_Comm comm ) {
+  if ( s.restart ) {
+    readRestart( step, buffer, s );
+    return;
+  }
+
+  PhaseClock<> clock;
   auto filename = MakeFilename( m_outputfilename, ".dat", s.rank, step );
   _filestream.open( filename, std::ios_base::in );
+  clock.lap( Phase::open );
+
+  if ( _compression.enabled() ) {
+    std::vector<char> frame( std::filesystem::file_size( filename ) );
+    _filestream.read( frame.data(), static_cast<std::streamsize>( frame.size() ) );
+    clock.lap( Phase::transfer );
+    _filestream.close();
+    clock.lap( Phase::close );
+    _compression.decode( frame, buffer );
+    clock.lap( Phase::compress );
+    return;
+  }
 
   auto read_size = static_cast<std::streamsize>( s.ndx * s.ndy * s.ndz * sizeof( double ) );
-  for ( auto& iteration : buffer ) {
-    _filestream.read( reinterpret_cast<char*>( iteration.data() ),
+  for ( size_t it = 0; it < buffer.size(); ++it ) {
+    // let the kernel fetch the next iteration while this one is copied
+    if ( s.prefetch && it + 1 < buffer.size() ) {
+      AdviseWillNeed( filename, static_cast<long long>( it + 1 ) * read_size, read_size );
+    }
+    _filestream.read( reinterpret_cast<char*>( buffer[it].data() ),
                       read_size );
   }
+  clock.lap( Phase::transfer );
 
   _filestream.close();
+  clock.lap( Phase::close );
+}
+
+// Reads the subdomain of this rank from the files of all writer ranks it overlaps
+void IObinary::readRestart( const int step,
+                            std::vector<std::vector<double> >& buffer,
+                            const Settings& s ) {
+  const bool withFolders = s.format.find("_with_folders") != std::string::npos;
+  const auto block_size = static_cast<std::streamoff>( s.wndx ) * s.wndy * s.wndz;
+
+  for ( const auto& overlap : writerOverlaps( s ) ) {
+    std::string basename = withFolders ? ProcFolderName( overlap.rank, s.layout ) + s.outputfile
+                                       : s.outputfile;
+    auto filename = MakeFilename( basename, ".dat", overlap.rank, step );
+    _filestream.open( filename, std::ios_base::in );
+
+    std::streamoff iteration_offset = 0;
+    for ( auto& iteration : buffer ) {
+      forEachRun( overlap, s,
+        [ this, &iteration, iteration_offset ]( size_t file, size_t mem, size_t length )
+        {
+          _filestream.seekg( static_cast<std::streamoff>( ( iteration_offset + file ) * sizeof( double ) ) );
+          _filestream.read( reinterpret_cast<char*>( iteration.data() + mem ),
+                            static_cast<std::streamsize>( length * sizeof( double ) ) );
+        } );
+      iteration_offset += block_size;
+    }
+
+    _filestream.close();
+  }
+}
+
+std::vector<std::string> IObinary::stepFiles( const int step, const Settings& s ) const {
+  if ( !s.restart ) {
+    return { MakeFilename( m_outputfilename, ".dat", s.rank, step ) };
+  }
+  const bool withFolders = s.format.find("_with_folders") != std::string::npos;
+  std::vector<std::string> files;
+  for ( const auto& overlap : writerOverlaps( s ) ) {
+    std::string basename = withFolders ? ProcFolderName( overlap.rank, s.layout ) + s.outputfile
+                                       : s.outputfile;
+    files.push_back( MakeFilename( basename, ".dat", overlap.rank, step ) );
+  }
+  return files;
 }
 
 void IObinary::remove( const int step ) {
@@ -0,0 +1,143 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * IOmdtest.cpp
+ *
+ *  Created on: Oct 2026
+ *      Author: Gregor Weiss
+ */
+
+#include "IOmdtest.h"
+#include "Durability.h"
+#include "helper.h"
+
+#include <iostream>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+// Rank 0 prints per phase the operations of all ranks per second of the slowest rank
+void printRates( const std::string& identifier,
+                 const std::vector<std::string>& phases,
+                 const std::vector<double>& ops,
+                 const std::vector<double>& seconds,
+                 MPI_Comm comm ) {
+  const int count = static_cast<int>( phases.size() );
+  std::vector<double> totalOps( count ), maxSeconds( count );
+  MPI_Reduce( ops.data(), totalOps.data(), count, MPI_DOUBLE, MPI_SUM, 0, comm );
+  MPI_Reduce( seconds.data(), maxSeconds.data(), count, MPI_DOUBLE, MPI_MAX, 0, comm );
+  if ( getRank( comm ) == 0 ) {
+    std::cout << identifier;
+    for ( int p = 0; p < count; ++p ) {
+      std::cout << " " << phases[p] << " [ops/s] " << totalOps[p] / maxSeconds[p];
+    }
+    std::cout << "\n";
+  }
+}
+
+} // namespace
+
+IOmdtest::IOmdtest( const Settings& s, MPI_Comm comm )
+  : _communicator{ comm }
+  , _files{ s.files }
+  , _layout{ s.layout } {
+  MPI_Barrier( comm );
+  _layoutTime = MPI_Wtime();
+  _folder = MakeProcFolders( s.rank, s.layout, comm ) + s.outputfile;
+  _layoutTime = MPI_Wtime() - _layoutTime;
+}
+
+std::string IOmdtest::stepDirectory( const int step ) const {
+  return MakeFilename( _folder, ".d", getRank( _communicator ), step );
+}
+
+std::string IOmdtest::fileName( const std::string& directory, unsigned int index ) const {
+  return directory + "/file." + std::to_string( index );
+}
+
+void IOmdtest::write( int step,
+                      const HeatTransfer& ht,
+                      const Settings& s,
+                      MPI_Comm comm ) {
+  write( step, ht.m_TIterations, s, comm );
+}
+
+void IOmdtest::write( int step,
+                      const std::vector<std::vector<double> >& iterations,
+                      const Settings& s,
+                      MPI_Comm comm ) {
+  if ( !_layoutReported ) {
+    double maxTime = 0.0;
+    MPI_Reduce( &_layoutTime, &maxTime, 1, MPI_DOUBLE, MPI_MAX, 0, comm );
+    if ( getRank( comm ) == 0 ) {
+      std::cout << "Metadata layout " << _layout
+                << " folders max. time [s] " << maxTime << "\n";
+    }
+    _layoutReported = true;
+  }
+
+  const auto directory = stepDirectory( step );
+  double seconds[2];
+  seconds[0] = MPI_Wtime();
+  if ( mkdir( directory.c_str(), 0755 ) != 0 ) {
+    std::cout << "IOmdtest: cannot create " << directory << std::endl;
+  }
+  seconds[1] = MPI_Wtime();
+  seconds[0] = seconds[1] - seconds[0];
+  const Durability durability = parseDurability( s.durability );
+  for ( unsigned int i = 0; i < _files; ++i ) {
+    int fd = open( fileName( directory, i ).c_str(), O_CREAT | O_EXCL | O_WRONLY, 0644 );
+    if ( fd >= 0 ) {
+      syncFile( fd, durability );
+      close( fd );
+    }
+  }
+  // the entries of the new files
+  syncFile( directory, durability );
+  seconds[1] = MPI_Wtime() - seconds[1];
+
+  printRates( "Metadata step " + std::to_string( step ), { "mkdir", "create" },
+              { 1.0, static_cast<double>( _files ) }, { seconds[0], seconds[1] }, comm );
+}
+
+void IOmdtest::read( const int step,
+                     std::vector<std::vector<double> >& buffer,
+                     const Settings& s,
+                     MPI_Comm comm ) {
+  const auto directory = stepDirectory( step );
+  unsigned int missing = 0;
+  double seconds = MPI_Wtime();
+  for ( unsigned int i = 0; i < _files; ++i ) {
+    struct stat status;
+    if ( stat( fileName( directory, i ).c_str(), &status ) != 0 ) {
+      ++missing;
+    }
+  }
+  seconds = MPI_Wtime() - seconds;
+
+  printRates( "Metadata step " + std::to_string( step ), { "stat" },
+              { static_cast<double>( _files ) }, { seconds }, comm );
+  if ( missing > 0 ) {
+    std::cout << "WARNING: rank " << s.rank << " misses " << missing << " files\n";
+  }
+}
+
+void IOmdtest::remove( const int step ) {
+  const auto directory = stepDirectory( step );
+  double seconds[2];
+  seconds[0] = MPI_Wtime();
+  for ( unsigned int i = 0; i < _files; ++i ) {
+    unlink( fileName( directory, i ).c_str() );
+  }
+  seconds[1] = MPI_Wtime();
+  seconds[0] = seconds[1] - seconds[0];
+  rmdir( directory.c_str() );
+  seconds[1] = MPI_Wtime() - seconds[1];
+
+  printRates( "Metadata step " + std::to_string( step ), { "unlink", "rmdir" },
+              { static_cast<double>( _files ), 1.0 }, { seconds[0], seconds[1] }, _communicator );
+}
@@ -0,0 +1,92 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * IOmdtest.h
+ *
+ *  Created on: Oct 2026
+ *      Author: Gregor Weiss
+ *
+ *  Metadata benchmark in the style of mdtest: per step every rank creates a
+ *  directory with files empty files in the folder of its layout (write),
+ *  stats them (read) and unlinks them (remove). No data is written, rank 0
+ *  prints the rate of every phase over all ranks.
+ */
+
+#ifndef IOMDTEST_H_
+#define IOMDTEST_H_
+
+#include "HeatTransfer.h"
+#include "Settings.h"
+
+#include <string>
+#include <vector>
+#include <mpi.h>
+
+class IOmdtest
+{
+ public:
+  IOmdtest() = default;
+
+  // creates the folders of the layout, timed
+  IOmdtest( const Settings& s, MPI_Comm comm );
+
+  ~IOmdtest() = default;
+
+  IOmdtest( IOmdtest const& other ) = delete;
+
+  IOmdtest& operator=( IOmdtest const& other ) = delete;
+
+  IOmdtest( IOmdtest&& other ) = default;
+
+  IOmdtest& operator=( IOmdtest&& other ) noexcept {
+    IOmdtest tmp{ std::move( other ) };
+    swap( tmp );
+    return *this;
+  }
+
+  void swap( IOmdtest& other ) noexcept {
+    using std::swap;
+    swap( _communicator, other._communicator );
+    swap( _folder, other._folder );
+    swap( _files, other._files );
+    swap( _layout, other._layout );
+    swap( _layoutTime, other._layoutTime );
+    swap( _layoutReported, other._layoutReported );
+  }
+
+  // mkdir and create
+  void write( int step,
+              const HeatTransfer& ht,
+              const Settings& s,
+              MPI_Comm comm );
+
+  // the iterations without the solver, e.g. from the drain of a burst buffer
+  void write( int step,
+              const std::vector<std::vector<double> >& iterations,
+              const Settings& s,
+              MPI_Comm comm );
+
+  // stat
+  void read( const int step,
+             std::vector<std::vector<double> >& buffer,
+             const Settings& s,
+             MPI_Comm comm );
+
+  // unlink and rmdir
+  void remove( const int step );
+
+ private:
+  std::string stepDirectory( const int step ) const;
+
+  std::string fileName( const std::string& directory, unsigned int index ) const;
+
+  MPI_Comm _communicator{ MPI_COMM_NULL };
+  std::string _folder{};
+  unsigned int _files{ 0 };
+  std::string _layout{};
+  double _layoutTime{ 0.0 };
+  bool _layoutReported{ false };
+};
+
+#endif /* IOMDTEST_H_ */
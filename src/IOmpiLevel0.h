@@ -11,9 +11,11 @@
 #ifndef IOMPILEVEL0_H_
 #define IOMPILEVEL0_H_
 
+#include "Compression.h"
 #include "HeatTransfer.h"
 #include "Settings.h"
 
+#include <string>
 #include <vector>
 #include <mpi.h>
 
@@ -44,21 +46,41 @@ class IOmpiLevel0
     swap( _communicator, other._communicator );
     swap( _outputfilename, other._outputfilename );
     swap( _buffercount, other._buffercount );
+    swap( _offset, other._offset );
     swap( _rank, other._rank );
     swap( _nprocs, other._nprocs );
+    swap( _compression, other._compression );
   }
   
   void write( int step,
               const HeatTransfer& ht,
               const Settings& s,
               MPI_Comm comm );
+
+  // the iterations without the solver, e.g. from the drain of a burst buffer
+  void write( int step,
+              const std::vector<std::vector<double> >& iterations,
+              const Settings& s,
+              MPI_Comm comm );
   
+  // streaming: the iterations of a step one at a time, the same file as write
+  void openStep( int step, const Settings& s, MPI_Comm comm );
+
+  void putIteration( const std::vector<double>& iteration, const Settings& s, MPI_Comm comm );
+
+  void closeStep( const Settings& s, MPI_Comm comm );
+
   void read( const int step,
              std::vector<std::vector<double> >& buffer,
              const Settings& s,
              MPI_Comm comm );
   
   void remove( const int step );
+
+  // files this rank reads of step
+  std::vector<std::string> stepFiles( const int step, const Settings& s ) const;
+
+  CompressionStage& compression() { return _compression; }
  
  private:
   MPI_File _filehandle{};
@@ -66,8 +88,10 @@ class IOmpiLevel0
   std::string _outputfilename{};
   MPI_Offset _disp{};
   int _buffercount{};
+  MPI_Offset _offset{};   // of the next iteration of the open step
   int _rank{};
   int _nprocs{};
+  CompressionStage _compression{};
 };
 
 void swap( IOmpiLevel0& a, IOmpiLevel0& b ) noexcept;
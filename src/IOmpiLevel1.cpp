@@ -11,6 +11,10 @@
  */
 
 #include "IOmpiLevel1.h"
+#include "Durability.h"
+#include "Hints.h"
+#include "Instrumentation.h"
+#include "Restart.h"
 #include "helper.h"
 
 #include <cstdio>
@@ -23,47 +27,120 @@ IOmpiLevel1::IOmpiLevel1( const Settings& s, MPI_Comm comm )
   , _disp{ static_cast<MPI_Offset>( sizeof(double) * s.gndx * s.gndy * s.gndz ) }
   , _buffercount{ static_cast<int>( s.ndx * s.ndy * s.ndz ) }
   , _rank{ getRank( comm ) }
-  , _nprocs{ getNProcs( comm ) } {}
+  , _nprocs{ getNProcs( comm ) }
+  , _compression{ s, comm } {}
 
 void IOmpiLevel1::write( int step,
                          const HeatTransfer& ht,
                          const Settings& s,
                          MPI_Comm comm ) {
+  write( step, ht.m_TIterations, s, comm );
+}
+
+void IOmpiLevel1::write( int step,
+                         const std::vector<std::vector<double> >& iterations,
+                         const Settings& s,
+                         MPI_Comm comm ) {
+  openStep( step, s, comm );
+
+  if ( _compression.enabled() ) {
+    PhaseClock<> clock;
+    auto frame = _compression.encode( iterations );
+    clock.lap( Phase::compress );
+    double writeTime = MPI_Wtime();
+    writeFrames( _filehandle, frame, comm, true );
+    _compression.addWriteTime( MPI_Wtime() - writeTime );
+    clock.lap( Phase::transfer );
+  } else {
+    for ( const auto& iteration : iterations ) {
+      putIteration( iteration, s, comm );
+    }
+  }
+
+  closeStep( s, comm );
+}
+
+void IOmpiLevel1::openStep( int step, const Settings& s, MPI_Comm comm ) {
+  PhaseClock<> clock;
   _outputfilename = MakeFilename( s.outputfile, ".mpiio_write", -1, step );
   
   // Open file and set initial rank-related offset
+  MPIInfo info( s.hints );
   MPI_File_open( comm,
                  _outputfilename.c_str(),
                  MPI_MODE_CREATE | MPI_MODE_WRONLY,
-                 MPI_INFO_NULL,
+                 info.get(),
                  &_filehandle );
+  _offset = static_cast<MPI_Offset>( _rank ) * _buffercount * sizeof( double );
+  clock.lap( Phase::open );
+}
 
-  MPI_Offset offset = _rank * _buffercount * sizeof( double );
-  for ( const auto& iteration : ht.m_TIterations ) {
-    MPI_File_seek( _filehandle, offset, MPI_SEEK_SET );
-    MPI_File_write_all( _filehandle,
-                        iteration.data(),
-                        _buffercount,
-                        MPI_DOUBLE,
-                        MPI_STATUS_IGNORE);
-    offset += _disp;
-  }
-  
+void IOmpiLevel1::putIteration( const std::vector<double>& iteration, const Settings& s, MPI_Comm comm ) {
+  PhaseClock<> clock;
+  MPI_File_seek( _filehandle, _offset, MPI_SEEK_SET );
+  MPI_File_write_all( _filehandle,
+                      iteration.data(),
+                      _buffercount,
+                      MPI_DOUBLE,
+                      MPI_STATUS_IGNORE);
+  _offset += _disp;
+  clock.lap( Phase::transfer );
+}
+
+void IOmpiLevel1::closeStep( const Settings& s, MPI_Comm comm ) {
+  PhaseClock<> clock;
+  syncFile( _filehandle, parseDurability( s.durability ) );
+  clock.lap( Phase::sync );
   MPI_File_close( &_filehandle );
+  clock.lap( Phase::close );
 }
 
 void IOmpiLevel1::read( const int step,
                         std::vector<std::vector<double> >& buffer,
                         const Settings& s,
                         MPI_Comm comm ) {
+  PhaseClock<> clock;
   _outputfilename = MakeFilename( s.outputfile, ".mpiio_write", -1, step );
 
   // Open file and set initial rank-related offset
+  MPIInfo info( s.hints );
   MPI_File_open( comm,
                  _outputfilename.c_str(),
                  MPI_MODE_RDONLY,
-                 MPI_INFO_NULL,
+                 info.get(),
                  &_filehandle );
+  clock.lap( Phase::open );
+
+  if ( _compression.enabled() ) {
+    auto frame = readFrame( _filehandle, comm, true );
+    clock.lap( Phase::transfer );
+    MPI_File_close( &_filehandle );
+    clock.lap( Phase::close );
+    _compression.decode( frame, buffer );
+    clock.lap( Phase::compress );
+    return;
+  }
+
+  if ( s.restart ) {
+    // Gather this rank's subdomain from the blocks of the writer decomposition
+    MPI_Datatype filetype, memtype;
+    restartTypes( s, filetype, memtype );
+    MPI_File_set_view( _filehandle, 0, MPI_DOUBLE, filetype, "native", MPI_INFO_NULL );
+    clock.lap( Phase::view );
+    for ( auto& iteration : buffer ) {
+      MPI_File_read_all( _filehandle,
+                         iteration.data(),
+                         1,
+                         memtype,
+                         MPI_STATUS_IGNORE );
+    }
+    MPI_Type_free( &filetype );
+    MPI_Type_free( &memtype );
+    clock.lap( Phase::transfer );
+    MPI_File_close( &_filehandle );
+    clock.lap( Phase::close );
+    return;
+  }
 
   MPI_Offset offset = _rank * _buffercount * sizeof( double );
   for ( auto& iteration : buffer ) {
@@ -75,8 +152,15 @@ void IOmpiLevel1::read( const int step,
                        MPI_STATUS_IGNORE);
     offset += _disp;
   }
+  clock.lap( Phase::transfer );
   
   MPI_File_close( &_filehandle );
+  clock.lap( Phase::close );
+}
+
+// the shared file of step, every rank reads parts of it
+std::vector<std::string> IOmpiLevel1::stepFiles( const int step, const Settings& s ) const {
+  return { MakeFilename( s.outputfile, ".mpiio_write", -1, step ) };
 }
 
 void IOmpiLevel1::remove( const int step ) {
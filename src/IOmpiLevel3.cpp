@@ -11,10 +11,15 @@
  */
 
 #include "IOmpiLevel3.h"
+#include "Durability.h"
+#include "Hints.h"
+#include "Instrumentation.h"
+#include "Restart.h"
 #include "helper.h"
 
 #include <cstdio>
 #include <iostream> // cout
+#include <stdexcept>
 
 #include <mpi.h>
 
@@ -48,37 +53,80 @@ IOmpiLevel3::IOmpiLevel3( const Settings& s, MPI_Comm communicator )
   , _outputfilename{ MakeFilename( s.outputfile, "mpi_write_all" ) }
   , _buffercount{ static_cast<int>( s.ndx * s.ndy * s.ndz ) }
   , _rank{ getRank( _communicator ) }
-  , _nprocs{ getNProcs( _communicator ) } {}
+  , _nprocs{ getNProcs( _communicator ) }
+  , _compression{ s, communicator } {}
 
 void IOmpiLevel3::write( int step,
                          const HeatTransfer& ht,
                          const Settings& s,
                          MPI_Comm comm ) {
+  write( step, ht.m_TIterations, s, comm );
+}
+
+void IOmpiLevel3::write( int step,
+                         const std::vector<std::vector<double> >& iterations,
+                         const Settings& s,
+                         MPI_Comm comm ) {
+  openStep( step, s, comm );
+
+  if ( _compression.enabled() ) {
+    PhaseClock<> clock;
+    auto frame = _compression.encode( iterations );
+    clock.lap( Phase::compress );
+    double writeTime = MPI_Wtime();
+    writeFrames( _filehandle, frame, comm, true );
+    _compression.addWriteTime( MPI_Wtime() - writeTime );
+    clock.lap( Phase::transfer );
+  } else {
+    for ( const auto& iteration : iterations ) {
+      putIteration( iteration, s, comm );
+    }
+  }
+
+  closeStep( s, comm );
+}
+
+void IOmpiLevel3::openStep( int step, const Settings& s, MPI_Comm comm ) {
+  PhaseClock<> clock;
   _outputfilename = MakeFilename( s.outputfile, ".mpiio_write_all", -1, step );
   
   // Open file and set file view
-  MPI_File filehandle_onestep;
+  MPIInfo info( s.hints );
   MPI_File_open( comm,
                  _outputfilename.c_str(),
                  MPI_MODE_CREATE | MPI_MODE_WRONLY,
-                 MPI_INFO_NULL,
-                 &filehandle_onestep );
+                 info.get(),
+                 &_filehandle );
+  clock.lap( Phase::open );
 
-  MPI_File_set_view( filehandle_onestep,
-                     0,
-                     MPI_DOUBLE,
-                     _fileview._filetype,
-                     "native",
-                     MPI_INFO_NULL );
-  for ( const auto& iteration : ht.m_TIterations ) {
-    MPI_File_write_all( filehandle_onestep,
-                        iteration.data(),
-                        _buffercount,
-                        MPI_DOUBLE,
-                        MPI_STATUS_IGNORE );
+  // Compressed frames vary in size and cannot follow the file view
+  if ( !_compression.enabled() ) {
+    MPI_File_set_view( _filehandle,
+                       0,
+                       MPI_DOUBLE,
+                       _fileview._filetype,
+                       "native",
+                       MPI_INFO_NULL );
+    clock.lap( Phase::view );
   }
-  
-  MPI_File_close( &filehandle_onestep );
+}
+
+void IOmpiLevel3::putIteration( const std::vector<double>& iteration, const Settings& s, MPI_Comm comm ) {
+  PhaseClock<> clock;
+  MPI_File_write_all( _filehandle,
+                      iteration.data(),
+                      _buffercount,
+                      MPI_DOUBLE,
+                      MPI_STATUS_IGNORE );
+  clock.lap( Phase::transfer );
+}
+
+void IOmpiLevel3::closeStep( const Settings& s, MPI_Comm comm ) {
+  PhaseClock<> clock;
+  syncFile( _filehandle, parseDurability( s.durability ) );
+  clock.lap( Phase::sync );
+  MPI_File_close( &_filehandle );
+  clock.lap( Phase::close );
 }
 
 void IOmpiLevel3::read( const int step,
@@ -87,29 +135,78 @@ void IOmpiLevel3::read( const int step,
                         MPI_Comm comm ) {
   _outputfilename = MakeFilename( s.outputfile, ".mpiio_write_all", -1, step );
 
+  // Only the 1D layouts store the blocks in rank order independent of the
+  // decomposition, the 2D layouts depend on the local array sizes
+  if ( s.restart && s.format.find("1D") == std::string::npos ) {
+    throw std::invalid_argument("Restart with another decomposition requires a 1D file view.");
+  }
+
   // Open file and set file view
+  PhaseClock<> clock;
   MPI_File filehandle_onestep;
+  MPIInfo info( s.hints );
   MPI_File_open( comm,
                  _outputfilename.c_str(),
                  MPI_MODE_RDONLY,
-                 MPI_INFO_NULL,
+                 info.get(),
                  &filehandle_onestep );
+  clock.lap( Phase::open );
 
-  MPI_File_set_view( filehandle_onestep,
-                     0,
-                     MPI_DOUBLE,
-                     _fileview._filetype,
-                     "native",
-                     MPI_INFO_NULL );
-  for ( auto& iteration : buffer ) {
-    MPI_File_read_all( filehandle_onestep,
-                       iteration.data(),
-                       _buffercount,
+  if ( _compression.enabled() ) {
+    auto frame = readFrame( filehandle_onestep, comm, true );
+    clock.lap( Phase::transfer );
+    MPI_File_close( &filehandle_onestep );
+    clock.lap( Phase::close );
+    _compression.decode( frame, buffer );
+    clock.lap( Phase::compress );
+    return;
+  }
+
+  if ( s.restart ) {
+    // Gather this rank's subdomain from the blocks of the writer decomposition
+    MPI_Datatype filetype, memtype;
+    restartTypes( s, filetype, memtype );
+    MPI_File_set_view( filehandle_onestep,
+                       0,
+                       MPI_DOUBLE,
+                       filetype,
+                       "native",
+                       MPI_INFO_NULL );
+    clock.lap( Phase::view );
+    for ( auto& iteration : buffer ) {
+      MPI_File_read_all( filehandle_onestep,
+                         iteration.data(),
+                         1,
+                         memtype,
+                         MPI_STATUS_IGNORE );
+    }
+    MPI_Type_free( &filetype );
+    MPI_Type_free( &memtype );
+  } else {
+    MPI_File_set_view( filehandle_onestep,
+                       0,
                        MPI_DOUBLE,
-                       MPI_STATUS_IGNORE );
+                       _fileview._filetype,
+                       "native",
+                       MPI_INFO_NULL );
+    clock.lap( Phase::view );
+    for ( auto& iteration : buffer ) {
+      MPI_File_read_all( filehandle_onestep,
+                         iteration.data(),
+                         _buffercount,
+                         MPI_DOUBLE,
+                         MPI_STATUS_IGNORE );
+    }
   }
+  clock.lap( Phase::transfer );
 
   MPI_File_close( &filehandle_onestep );
+  clock.lap( Phase::close );
+}
+
+// the shared file of step, every rank reads parts of it
+std::vector<std::string> IOmpiLevel3::stepFiles( const int step, const Settings& s ) const {
+  return { MakeFilename( s.outputfile, ".mpiio_write_all", -1, step ) };
 }
 
 void IOmpiLevel3::remove( const int step ) {
@@ -0,0 +1,79 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * IOshmstage.cpp
+ *
+ *  Created on: Oct 2026
+ *      Author: Gregor Weiss
+ */
+
+#include "IOshmstage.h"
+#include "helper.h"
+
+#include <iostream>
+#include <stdexcept>
+
+IOshmstage::IOshmstage( const Settings& s, MPI_Comm comm )
+  : _name{ ShmRing::segmentName( s.outputfile, s.rank ) } {}
+
+void IOshmstage::write( int step,
+                        const HeatTransfer& ht,
+                        const Settings& s,
+                        MPI_Comm comm ) {
+  write( step, ht.m_TIterations, s, comm );
+}
+
+void IOshmstage::write( int step,
+                        const std::vector<std::vector<double> >& iterations,
+                        const Settings& s,
+                        MPI_Comm comm ) {
+  const size_t bytes = sizeof( double ) * s.ndx * s.ndy * s.ndz;
+  // created on the first write, so that a reading instance leaves the ring alone
+  if ( !_ring.valid() ) {
+    _ring = ShmRing::create( _name, s.slots, bytes, s.timeout );
+  }
+
+  double stall = 0.0;
+  std::string error;
+  try {
+    for ( size_t it = 0; it < iterations.size(); ++it ) {
+      stall += _ring.publish( static_cast<std::uint64_t>( step ),
+                              it,
+                              iterations[it].data(),
+                              bytes,
+                              s.verify );
+    }
+  } catch ( std::runtime_error& e ) {
+    error = e.what();
+  }
+  // a rank without consumer must not leave the others in the reduction below
+  int failed = error.empty() ? 0 : 1;
+  int anyFailed = 0;
+  MPI_Allreduce( &failed, &anyFailed, 1, MPI_INT, MPI_MAX, comm );
+  if ( anyFailed != 0 ) {
+    throw std::runtime_error( failed != 0 ? error : "IOshmstage::write: the consumer of another rank is gone" );
+  }
+
+  double maxStall = 0.0;
+  MPI_Reduce( &stall, &maxStall, 1, MPI_DOUBLE, MPI_MAX, 0, comm );
+  if ( getRank( comm ) == 0 ) {
+    std::cout << "Staging step " << step
+              << " slots " << _ring.slots()
+              << " max. backpressure [s] " << maxStall << "\n";
+  }
+}
+
+void IOshmstage::read( const int step,
+                       std::vector<std::vector<double> >& buffer,
+                       const Settings& s,
+                       MPI_Comm comm ) {
+  // rejected by Settings, the consumer reads the ring
+}
+
+// published slots are gone once the consumer released them
+void IOshmstage::remove( const int step ) {}
+
+double IOshmstage::heldBytes() const {
+  return static_cast<double>( _ring.slots() ) * static_cast<double>( _ring.slotBytes() );
+}
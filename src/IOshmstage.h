@@ -0,0 +1,79 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * IOshmstage.h
+ *
+ *  Created on: Oct 2026
+ *      Author: Gregor Weiss
+ *
+ *  Node-local staging: every rank publishes its iterations into a shared
+ *  memory ring that the consumer executable of the same rank drains.
+ */
+
+#ifndef IOSHMSTAGE_H_
+#define IOSHMSTAGE_H_
+
+#include "HeatTransfer.h"
+#include "Settings.h"
+#include "ShmRing.h"
+
+#include <string>
+#include <vector>
+#include <mpi.h>
+
+class IOshmstage
+{
+ public:
+  IOshmstage() = default;
+
+  IOshmstage( const Settings& s, MPI_Comm comm );
+
+  ~IOshmstage() = default;
+
+  IOshmstage( IOshmstage const& other ) = delete;
+
+  IOshmstage& operator=( IOshmstage const& other ) = delete;
+
+  IOshmstage( IOshmstage&& other ) = default;
+
+  IOshmstage& operator=( IOshmstage&& other ) noexcept {
+    IOshmstage tmp{ std::move( other ) };
+    swap( tmp );
+    return *this;
+  }
+
+  void swap( IOshmstage& other ) noexcept {
+    using std::swap;
+    swap( _name, other._name );
+    swap( _ring, other._ring );
+  }
+
+  // blocks while the consumer lags more than the ring's slots behind
+  void write( int step,
+              const HeatTransfer& ht,
+              const Settings& s,
+              MPI_Comm comm );
+
+  // the iterations without the solver, e.g. from the drain of a burst buffer
+  void write( int step,
+              const std::vector<std::vector<double> >& iterations,
+              const Settings& s,
+              MPI_Comm comm );
+
+  void read( const int step,
+             std::vector<std::vector<double> >& buffer,
+             const Settings& s,
+             MPI_Comm comm );
+
+  void remove( const int step );
+
+  // bytes of the shared memory ring
+  double heldBytes() const;
+
+ private:
+  std::string _name{};
+  ShmRing _ring{};
+};
+
+#endif /* IOSHMSTAGE_H_ */
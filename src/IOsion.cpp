@@ -11,6 +11,9 @@
 #ifdef HAVE_SIONLIB
 
 #include "IOsion.h"
+#include "Durability.h"
+#include "Instrumentation.h"
+#include "Restart.h"
 #include "helper.h"
 
 #include <stdio.h>
@@ -30,26 +33,47 @@ void IOsion::write( int step,
                     const HeatTransfer& ht,
                     const Settings& s,
                     MPI_Comm comm ) {
-  std::vector<double> v = ht.data_noghost();
+  write( step, ht.m_TIterations, s, comm );
+}
 
+void IOsion::write( int step,
+                    const std::vector<std::vector<double> >& iterations,
+                    const Settings& s,
+                    MPI_Comm comm ) {
+  PhaseClock<> clock;
   _fileName = MakeFilename( s.outputfile, ".sion", -1, step );
   _sionFileId = sion_paropen_mpi( _fileName.c_str(), "bw", &_numFiles, _communicator, &_communicator,
                                    &_chunkSize, &_fsBlockSize, &_rank, &_filePtr, &_newFileName );
+  clock.lap( Phase::open );
   
-  for ( const auto& iteration : ht.m_TIterations ) {
+  for ( const auto& iteration : iterations ) {
     sion_fwrite( iteration.data(),
                  sizeof( double ),
                  s.ndx * s.ndy * s.ndz,
                  _sionFileId );
   }
+  clock.lap( Phase::transfer );
   
+  const Durability durability = parseDurability( s.durability );
+  if ( durability != Durability::none && _filePtr != nullptr ) {
+    fflush( _filePtr );
+    syncFile( fileno( _filePtr ), durability );
+  }
+  clock.lap( Phase::sync );
   sion_parclose_mpi( _sionFileId );
+  clock.lap( Phase::close );
 }
 
 void IOsion::read( const int step,
                    std::vector<std::vector<double> >& buffer,
                    const Settings& s,
                    MPI_Comm comm ) {
+  if ( s.restart ) {
+    readRestart( step, buffer, s );
+    return;
+  }
+
+  PhaseClock<> clock;
   _fileName = MakeFilename( s.outputfile, ".sion", -1, step );
   _sionFileId = sion_paropen_mpi( _fileName.c_str(),
                                   "br",
@@ -61,6 +85,7 @@ void IOsion::read( const int step,
                                   &_rank,
                                   &_filePtr,
                                   &_newFileName );
+  clock.lap( Phase::open );
 
   for ( auto& iteration : buffer ) {
     sion_fread( iteration.data(),
@@ -68,8 +93,58 @@ void IOsion::read( const int step,
                 s.ndx * s.ndy * s.ndz,
                 _sionFileId );
   }
+  clock.lap( Phase::transfer );
 
   sion_parclose_mpi( _sionFileId );
+  clock.lap( Phase::close );
+}
+
+// Reads the subdomain of this rank from the chunks of all writer ranks it overlaps.
+// The file is opened in serial mode as the number of tasks differs from the writer.
+void IOsion::readRestart( const int step,
+                          std::vector<std::vector<double> >& buffer,
+                          const Settings& s ) {
+  _fileName = MakeFilename( s.outputfile, ".sion", -1, step );
+
+  int ntasks = 0;
+  int nfiles = 0;
+  sion_int64* chunksizes = nullptr;
+  int* globalranks = nullptr;
+  int sid = sion_open( _fileName.data(),
+                       "br",
+                       &ntasks,
+                       &nfiles,
+                       &chunksizes,
+                       &_fsBlockSize,
+                       &globalranks,
+                       &_filePtr );
+
+  const auto block_size = static_cast<sion_int64>( s.wndx ) * s.wndy * s.wndz;
+  for ( const auto& overlap : writerOverlaps( s ) ) {
+    sion_int64 iteration_offset = 0;
+    for ( auto& iteration : buffer ) {
+      forEachRun( overlap, s,
+        [ sid, &overlap, &iteration, iteration_offset ]( size_t file, size_t mem, size_t length )
+        {
+          sion_seek( sid,
+                     overlap.rank,
+                     SION_ABSOLUTE_POS,
+                     static_cast<sion_int64>( ( iteration_offset + file ) * sizeof( double ) ) );
+          sion_fread( iteration.data() + mem,
+                      sizeof( double ),
+                      length,
+                      sid );
+        } );
+      iteration_offset += block_size;
+    }
+  }
+
+  sion_close( sid );
+}
+
+// the shared file of step, every rank reads parts of it
+std::vector<std::string> IOsion::stepFiles( const int step, const Settings& s ) const {
+  return { MakeFilename( s.outputfile, ".sion", -1, step ) };
 }
 
 void IOsion::remove( const int step ) {
@@ -15,6 +15,7 @@
 #include "Settings.h"
 
 #include <fstream>
+#include <string>
 #include <vector>
 #include <mpi.h>
 
@@ -57,6 +58,12 @@ class IOsion
               const HeatTransfer& ht,
               const Settings& s,
               MPI_Comm comm );
+
+  // the iterations without the solver, e.g. from the drain of a burst buffer
+  void write( int step,
+              const std::vector<std::vector<double> >& iterations,
+              const Settings& s,
+              MPI_Comm comm );
   
   void read( const int step,
              std::vector<std::vector<double> >& buffer,
@@ -64,8 +71,15 @@ class IOsion
              MPI_Comm comm );
 
   void remove( const int step );
+
+  // files this rank reads of step
+  std::vector<std::string> stepFiles( const int step, const Settings& s ) const;
  
  private:
+  void readRestart( const int step,
+                    std::vector<std::vector<double> >& buffer,
+                    const Settings& s );
+
   std::string _fileName{};
   MPI_Comm _communicator;
   sion_int64 _chunkSize{ 10 * 1024 * 1024 };
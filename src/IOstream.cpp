@@ -9,6 +9,9 @@
  */
 
 #include "IOstream.h"
+#include "Durability.h"
+#include "Instrumentation.h"
+#include "Restart.h"
 #include "helper.h"
 
 #include <iostream> //std::cout
@@ -17,9 +20,11 @@
 #include <unistd.h>
 
 #include <cassert>
+#include <vector>
 
 IOstream::IOstream( const Settings& s, MPI_Comm comm )
-  : _filename{ MakeFilename( s.outputfile, ".dat", s.rank ) } {}
+  : _filename{ MakeFilename( s.outputfile, ".dat", s.rank ) }
+  , _compression{ s, comm } {}
 
 IOstream::~IOstream() {}
 
@@ -27,38 +32,149 @@ void IOstream::write( int step,
                       const HeatTransfer& ht,
                       const Settings& s,
                       MPI_Comm comm ) {
+  write( step, ht.m_TIterations, s, comm );
+}
+
+void IOstream::write( int step,
+                      const std::vector<std::vector<double> >& iterations,
+                      const Settings& s,
+                      MPI_Comm comm ) {
+  openStep( step, s, comm );
+
+  if ( _compression.enabled() ) {
+    PhaseClock<> clock;
+    _compression.encode( iterations,
+                         [ this ]( const char* data, size_t bytes ) { writeChunk( data, bytes ); } );
+    clock.lap( Phase::transfer );
+  } else {
+    for ( const auto& iteration : iterations ) {
+      putIteration( iteration, s, comm );
+    }
+  }
+
+  closeStep( s, comm );
+}
+
+void IOstream::openStep( int step, const Settings& s, MPI_Comm comm ) {
+  PhaseClock<> clock;
+  _durability = parseDurability( s.durability );
   _filename = MakeFilename( s.outputfile, ".dat", s.rank, step );
   _filestream = fopen( _filename.c_str(), "w" );
-  
-  auto write_size = s.ndx * s.ndy * s.ndz;
-  for ( const auto& iteration : ht.m_TIterations ) {
-    fwrite( reinterpret_cast<const char*>(iteration.data()),
-            sizeof( double ),
-            write_size,
-            _filestream );
-  }
-  
+  _offset = 0;
+  clock.lap( Phase::open );
+}
+
+void IOstream::putIteration( const std::vector<double>& iteration, const Settings& s, MPI_Comm comm ) {
+  PhaseClock<> clock;
+  writeChunk( reinterpret_cast<const char*>( iteration.data() ),
+              sizeof( double ) * s.ndx * s.ndy * s.ndz );
+  clock.lap( Phase::transfer );
+}
+
+void IOstream::closeStep( const Settings& s, MPI_Comm comm ) {
+  PhaseClock<> clock;
+  // the descriptor is only valid until fclose
+  fflush( _filestream );
+  syncFile( fileno( _filestream ), _durability );
+  clock.lap( Phase::sync );
   fclose( _filestream );
-  fsync( fileno( _filestream ));
+  clock.lap( Phase::close );
+}
+
+void IOstream::writeChunk( const char* data, size_t bytes ) {
+  fwrite( data, 1, bytes, _filestream );
+  if ( _durability == Durability::range ) {
+    fflush( _filestream );
+    syncChunk( fileno( _filestream ), _offset, static_cast<long long>( bytes ), _durability );
+  }
+  _offset += static_cast<long long>( bytes );
 }
 
 void IOstream::read( const int step,
                      std::vector<std::vector<double> >& buffer,
                      const Settings& s,
                      MPI_Comm comm ) {
+  if ( s.restart ) {
+    readRestart( step, buffer, s );
+    return;
+  }
+
+  PhaseClock<> clock;
   _filename = MakeFilename( s.outputfile, ".dat", s.rank, step );
   _filestream = fopen( _filename.c_str(), "r" );
+  clock.lap( Phase::open );
+
+  if ( _compression.enabled() ) {
+    fseeko( _filestream, 0, SEEK_END );
+    std::vector<char> frame( static_cast<size_t>( ftello( _filestream ) ) );
+    fseeko( _filestream, 0, SEEK_SET );
+    size_t count = fread( frame.data(), 1, frame.size(), _filestream );
+    assert(count==frame.size());
+    clock.lap( Phase::transfer );
+    fclose( _filestream );
+    clock.lap( Phase::close );
+    _compression.decode( frame, buffer );
+    clock.lap( Phase::compress );
+    return;
+  }
 
   auto read_size = s.ndx * s.ndy * s.ndz;
-  for ( auto& iteration : buffer ) {
-    size_t count = fread( reinterpret_cast<char*>(iteration.data()),
+  const auto iteration_bytes = static_cast<long long>( read_size * sizeof( double ) );
+  for ( size_t it = 0; it < buffer.size(); ++it ) {
+    // let the kernel fetch the next iteration while this one is copied
+    if ( s.prefetch && it + 1 < buffer.size() ) {
+      AdviseWillNeed( fileno( _filestream ), static_cast<long long>( it + 1 ) * iteration_bytes, iteration_bytes );
+    }
+    size_t count = fread( reinterpret_cast<char*>(buffer[it].data()),
                           sizeof( double ),
                           read_size,
                           _filestream );
     assert(count==read_size);
   }
+  clock.lap( Phase::transfer );
 
   fclose( _filestream );
+  clock.lap( Phase::close );
+}
+
+// Reads the subdomain of this rank from the files of all writer ranks it overlaps
+void IOstream::readRestart( const int step,
+                            std::vector<std::vector<double> >& buffer,
+                            const Settings& s ) {
+  const auto block_size = static_cast<off_t>( s.wndx ) * s.wndy * s.wndz;
+
+  for ( const auto& overlap : writerOverlaps( s ) ) {
+    _filename = MakeFilename( s.outputfile, ".dat", overlap.rank, step );
+    _filestream = fopen( _filename.c_str(), "r" );
+
+    off_t iteration_offset = 0;
+    for ( auto& iteration : buffer ) {
+      forEachRun( overlap, s,
+        [ this, &iteration, iteration_offset ]( size_t file, size_t mem, size_t length )
+        {
+          fseeko( _filestream, static_cast<off_t>( ( iteration_offset + file ) * sizeof( double ) ), SEEK_SET );
+          size_t count = fread( reinterpret_cast<char*>( iteration.data() + mem ),
+                                sizeof( double ),
+                                length,
+                                _filestream );
+          assert(count==length);
+        } );
+      iteration_offset += block_size;
+    }
+
+    fclose( _filestream );
+  }
+}
+
+std::vector<std::string> IOstream::stepFiles( const int step, const Settings& s ) const {
+  if ( !s.restart ) {
+    return { MakeFilename( s.outputfile, ".dat", s.rank, step ) };
+  }
+  std::vector<std::string> files;
+  for ( const auto& overlap : writerOverlaps( s ) ) {
+    files.push_back( MakeFilename( s.outputfile, ".dat", overlap.rank, step ) );
+  }
+  return files;
 }
 
 void IOstream::remove( const int step ) {
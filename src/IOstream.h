@@ -11,10 +11,13 @@
 #ifndef IOSTREAM_H_
 #define IOSTREAM_H_
 
+#include "Compression.h"
+#include "Durability.h"
 #include "HeatTransfer.h"
 #include "Settings.h"
 
 #include <fstream>
+#include <string>
 #include <vector>
 #include <mpi.h>
 
@@ -32,7 +35,8 @@ class IOstream
   IOstream& operator=( IOstream const& other ) = delete;
   
   IOstream( IOstream&& other ) noexcept
-    : _filename{ std::move( other._filename ) } {}
+    : _filename{ std::move( other._filename ) }
+    , _compression{ std::move( other._compression ) } {}
   
   IOstream& operator=( IOstream&& other ) noexcept {
     IOstream tmp{ std::move( other ) };
@@ -43,23 +47,55 @@ class IOstream
   void swap( IOstream& other ) noexcept {
     using std::swap;
     swap( _filename, other._filename );
+    swap( _compression, other._compression );
+    swap( _filestream, other._filestream );
+    swap( _offset, other._offset );
+    swap( _durability, other._durability );
   }
   
   void write( int step,
               const HeatTransfer& ht,
               const Settings& s,
               MPI_Comm comm );
+
+  // the iterations without the solver, e.g. from the drain of a burst buffer
+  void write( int step,
+              const std::vector<std::vector<double> >& iterations,
+              const Settings& s,
+              MPI_Comm comm );
   
+  // streaming: the iterations of a step one at a time, the same file as write
+  void openStep( int step, const Settings& s, MPI_Comm comm );
+
+  void putIteration( const std::vector<double>& iteration, const Settings& s, MPI_Comm comm );
+
+  void closeStep( const Settings& s, MPI_Comm comm );
+
   void read( const int step,
              std::vector<std::vector<double> >& buffer,
              const Settings& s,
              MPI_Comm comm );
 
   void remove( const int step );
+
+  // files this rank reads of step
+  std::vector<std::string> stepFiles( const int step, const Settings& s ) const;
+
+  CompressionStage& compression() { return _compression; }
  
  private:
+  void readRestart( const int step,
+                    std::vector<std::vector<double> >& buffer,
+                    const Settings& s );
+
+  // writes a chunk of the open step, with range its writeback is started
+  void writeChunk( const char* data, size_t bytes );
+
   std::string _filename{};
-  FILE* _filestream;
+  FILE* _filestream{ nullptr };
+  long long _offset{ 0 };    // bytes of the open step
+  Durability _durability{ Durability::none };
+  CompressionStage _compression{};
 };
 
 #endif /* IOSTREAM_H_ */
@@ -0,0 +1,99 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * Instrumentation.cpp
+ *
+ *  Created on: Oct 2026
+ *      Author: Gregor Weiss
+ */
+
+#include "Instrumentation.h"
+#include "helper.h"
+
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+#include <vector>
+
+namespace {
+
+// nearest rank percentile of sorted values
+double percentile( const std::vector<double>& sorted, double p ) {
+  std::size_t index = static_cast<std::size_t>( p * static_cast<double>( sorted.size() - 1 ) + 0.5 );
+  return sorted[std::min( index, sorted.size() - 1 )];
+}
+
+template<typename Policy>
+void print( std::string_view identifier, double factor, MPI_Comm comm ) {
+  if constexpr ( Policy::enabled ) {
+    const int rank = getRank( comm );
+    const int nprocs = getNProcs( comm );
+    const auto& local = recorder<Policy>().seconds;
+    std::vector<double> all( rank == 0 ? phaseCount * static_cast<std::size_t>( nprocs ) : 0 );
+    MPI_Gather( local.data(), static_cast<int>( phaseCount ), MPI_DOUBLE,
+                all.data(), static_cast<int>( phaseCount ), MPI_DOUBLE, 0, comm );
+    if ( rank != 0 ) {
+      return;
+    }
+
+    std::cout << identifier << " phases\n";
+    std::vector<double> values( static_cast<std::size_t>( nprocs ) );
+    double median = 0.0;
+    std::array<int, 10> histogram{};
+    for ( std::size_t p = 0; p < phaseCount; ++p ) {
+      for ( int r = 0; r < nprocs; ++r ) {
+        values[r] = all[static_cast<std::size_t>( r ) * phaseCount + p];
+      }
+      std::sort( values.begin(), values.end() );
+      if ( values.back() == 0.0 ) {
+        continue;
+      }
+      if ( static_cast<Phase>( p ) == Phase::total ) {
+        median = percentile( values, 0.5 );
+        const double width = ( values.back() - values.front() ) / histogram.size();
+        for ( double value : values ) {
+          std::size_t bin = width > 0.0 ? static_cast<std::size_t>( ( value - values.front() ) / width ) : 0;
+          ++histogram[std::min( bin, histogram.size() - 1 )];
+        }
+      }
+      std::cout << "    " << phaseNames[p]
+                << " min/avg/max [s] " << values.front()
+                << " " << std::accumulate( values.begin(), values.end(), 0.0 ) / nprocs
+                << " " << values.back()
+                << " p50/p90/p99 [s] " << percentile( values, 0.5 )
+                << " " << percentile( values, 0.9 )
+                << " " << percentile( values, 0.99 ) << "\n";
+    }
+
+    std::cout << "    total ranks per tenth of min..max";
+    for ( int count : histogram ) {
+      std::cout << " " << count;
+    }
+    std::cout << "\n";
+
+    // stragglers by their total time
+    const std::size_t total = static_cast<std::size_t>( Phase::total );
+    int stragglers = 0;
+    for ( int r = 0; r < nprocs; ++r ) {
+      double seconds = all[static_cast<std::size_t>( r ) * phaseCount + total];
+      if ( median > 0.0 && seconds > factor * median ) {
+        if ( stragglers < 8 ) {
+          std::cout << "    straggler rank " << r
+                    << " total [s] " << seconds
+                    << " x median " << seconds / median << "\n";
+        }
+        ++stragglers;
+      }
+    }
+    if ( stragglers > 0 ) {
+      std::cout << "    " << stragglers << " ranks above " << factor << " x median\n";
+    }
+  }
+}
+
+} // namespace
+
+void printPhases( std::string_view identifier, double factor, MPI_Comm comm ) {
+  print<Recorder>( identifier, factor, comm );
+}
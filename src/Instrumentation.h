@@ -0,0 +1,98 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * Instrumentation.h
+ *
+ *  Created on: Oct 2026
+ *      Author: Gregor Weiss
+ *
+ *  Per-rank phase timers of the backends. The recording policy is chosen at
+ *  compile time: built without -Dwith-instrumentation the NullRecorder turns
+ *  every timer into nothing. A recording policy with a trace enabled also
+ *  puts every lap but the total as an event on the time line.
+ */
+
+#ifndef INSTRUMENTATION_H_
+#define INSTRUMENTATION_H_
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+#include <mpi.h>
+
+#include "Trace.h"
+
+enum class Phase : std::size_t { open, view, compress, transfer, close, sync, total, count };
+
+constexpr std::size_t phaseCount = static_cast<std::size_t>( Phase::count );
+
+constexpr std::array<const char*, phaseCount> phaseNames{
+  "open", "view", "compress", "transfer", "close", "sync", "total" };
+
+// Records nothing
+struct NullRecorder
+{
+  static constexpr bool enabled = false;
+
+  void reset() {}
+
+  void add( Phase, double ) {}
+};
+
+// Sums the seconds spent in every phase since the last reset
+struct PhaseRecorder
+{
+  static constexpr bool enabled = true;
+
+  std::array<double, phaseCount> seconds{};
+
+  void reset() { seconds.fill( 0.0 ); }
+
+  void add( Phase phase, double elapsed ) { seconds[static_cast<std::size_t>( phase )] += elapsed; }
+};
+
+#ifdef HAVE_INSTRUMENTATION
+using Recorder = PhaseRecorder;
+#else
+using Recorder = NullRecorder;
+#endif
+
+// Recorder of the calling thread, the drain of a burst buffer records apart
+template<typename Policy = Recorder>
+Policy& recorder() {
+  thread_local Policy instance;
+  return instance;
+}
+
+// Charges the time since construction or the last lap to a phase
+template<typename Policy = Recorder>
+class PhaseClock
+{
+ public:
+  PhaseClock() {
+    if constexpr ( Policy::enabled ) {
+      _last = trace::now();
+    }
+  }
+
+  void lap( Phase phase ) {
+    if constexpr ( Policy::enabled ) {
+      double now = trace::now();
+      recorder<Policy>().add( phase, now - _last );
+      if ( trace::enabled && phase != Phase::total ) {
+        trace::event( phaseNames[static_cast<std::size_t>( phase )], "phase", _last, now );
+      }
+      _last = now;
+    }
+  }
+
+ private:
+  double _last{ 0.0 };
+};
+
+// Rank 0 prints min/avg/max and percentiles of every phase over all ranks and
+// the ranks whose total exceeds factor times the median, collective
+void printPhases( std::string_view identifier, double factor, MPI_Comm comm );
+
+#endif /* INSTRUMENTATION_H_ */
@@ -0,0 +1,131 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * Metrics.cpp
+ *
+ *  Created on: Oct 2026
+ *      Author: Gregor Weiss
+ */
+
+#include "Metrics.h"
+
+#include <algorithm>
+#include <cmath>
+
+void ErrorMetrics::add( double reference, double value ) {
+  double error = reference - value;
+  count += 1.0;
+  min = std::min( min, reference );
+  max = std::max( max, reference );
+  sumSquaredError += error * error;
+  maxAbsError = std::max( maxAbsError, std::fabs( error ) );
+}
+
+void ErrorMetrics::merge( const ErrorMetrics& other ) {
+  count += other.count;
+  min = std::min( min, other.min );
+  max = std::max( max, other.max );
+  sumSquaredError += other.sumSquaredError;
+  maxAbsError = std::max( maxAbsError, other.maxAbsError );
+}
+
+namespace {
+
+static_assert( sizeof( ErrorMetrics ) == 5 * sizeof( double ),
+               "ErrorMetrics is reduced as five doubles" );
+
+void mergeMetrics( void* in, void* inout, int* len, MPI_Datatype* ) {
+  const auto* a = static_cast<const ErrorMetrics*>( in );
+  auto* b = static_cast<ErrorMetrics*>( inout );
+  for ( int i = 0; i < *len; ++i ) {
+    b[i].merge( a[i] );
+  }
+}
+
+// Datatype and operation are created on first use and live until MPI_Finalize
+struct MetricsReduction
+{
+  MPI_Datatype type;
+  MPI_Op op;
+
+  MetricsReduction() {
+    MPI_Type_contiguous( 5, MPI_DOUBLE, &type );
+    MPI_Type_commit( &type );
+    MPI_Op_create( &mergeMetrics, 1, &op );
+  }
+};
+
+const MetricsReduction& metricsReduction() {
+  static const MetricsReduction reduction;
+  return reduction;
+}
+
+} // namespace
+
+ErrorMetrics ErrorMetrics::reduce( MPI_Comm comm ) const {
+  const auto& reduction = metricsReduction();
+  ErrorMetrics global;
+  MPI_Allreduce( this, &global, 1, reduction.type, reduction.op, comm );
+  return global;
+}
+
+ErrorMetrics ErrorMetrics::reduce( MPI_Comm comm, int root ) const {
+  const auto& reduction = metricsReduction();
+  ErrorMetrics global;
+  MPI_Reduce( this, &global, 1, reduction.type, reduction.op, root, comm );
+  return global;
+}
+
+double ErrorMetrics::mse() const {
+  return count > 0.0 ? sumSquaredError / count : 0.0;
+}
+
+double ErrorMetrics::psnr() const {
+  return 20 * std::log10( ( max - min ) / ( 2 * std::sqrt( mse() ) ) );
+}
+
+ErrorMetrics measureError( const std::vector<std::vector<double> >& reference,
+                           const std::vector<std::vector<double> >& values ) {
+  // independent accumulators per lane, so that the compiler can keep them
+  // in vector registers without reassociating floating point sums
+  constexpr std::size_t lanes = 4;
+  double minima[lanes], maxima[lanes], sums[lanes], errors[lanes];
+  for ( std::size_t l = 0; l < lanes; ++l ) {
+    minima[l] = std::numeric_limits<double>::max();
+    maxima[l] = std::numeric_limits<double>::lowest();
+    sums[l] = 0.0;
+    errors[l] = 0.0;
+  }
+
+  ErrorMetrics metrics;
+  for ( std::size_t it = 0; it < std::min( reference.size(), values.size() ); ++it ) {
+    const double* ref = reference[it].data();
+    const double* val = values[it].data();
+    const std::size_t n = std::min( reference[it].size(), values[it].size() );
+    const std::size_t body = n - n % lanes;
+    for ( std::size_t i = 0; i < body; i += lanes ) {
+      for ( std::size_t l = 0; l < lanes; ++l ) {
+        const double r = ref[i + l];
+        const double e = r - val[i + l];
+        minima[l] = r < minima[l] ? r : minima[l];
+        maxima[l] = r > maxima[l] ? r : maxima[l];
+        sums[l] += e * e;
+        const double a = std::fabs( e );
+        errors[l] = a > errors[l] ? a : errors[l];
+      }
+    }
+    for ( std::size_t i = body; i < n; ++i ) {
+      metrics.add( ref[i], val[i] );
+    }
+    metrics.count += static_cast<double>( body );
+  }
+
+  for ( std::size_t l = 0; l < lanes; ++l ) {
+    metrics.min = std::min( metrics.min, minima[l] );
+    metrics.max = std::max( metrics.max, maxima[l] );
+    metrics.sumSquaredError += sums[l];
+    metrics.maxAbsError = std::max( metrics.maxAbsError, errors[l] );
+  }
+  return metrics;
+}
@@ -0,0 +1,47 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * Metrics.h
+ *
+ *  Created on: Oct 2026
+ *      Author: Gregor Weiss
+ */
+
+#ifndef METRICS_H_
+#define METRICS_H_
+
+#include <limits>
+#include <vector>
+#include <mpi.h>
+
+// Error of data against a reference, accumulated locally and reduced over all processes
+struct ErrorMetrics
+{
+  double count{ 0.0 };
+  double min{ std::numeric_limits<double>::max() };     // of the reference
+  double max{ std::numeric_limits<double>::lowest() };  // of the reference
+  double sumSquaredError{ 0.0 };
+  double maxAbsError{ 0.0 };
+
+  void add( double reference, double value );
+
+  void merge( const ErrorMetrics& other );
+
+  // global metrics, available on every process of comm
+  ErrorMetrics reduce( MPI_Comm comm ) const;
+
+  // global metrics, available on root only
+  ErrorMetrics reduce( MPI_Comm comm, int root ) const;
+
+  double mse() const;
+
+  // value range over twice the root mean squared error, in dB
+  double psnr() const;
+};
+
+// Error of all iterations against the reference in one fused pass
+ErrorMetrics measureError( const std::vector<std::vector<double> >& reference,
+                           const std::vector<std::vector<double> >& values );
+
+#endif /* METRICS_H_ */
@@ -0,0 +1,164 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * Removal.cpp
+ *
+ *  Created on: Oct 2026
+ *      Author: Gregor Weiss
+ */
+
+#include "Removal.h"
+#include "helper.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <set>
+
+namespace {
+
+double now() {
+  return std::chrono::duration<double>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+} // namespace
+
+RemovalService::RemovalService( MPI_Comm comm, bool threaded )
+  : _comm{ comm }
+  , _rank{ getRank( comm ) }
+  , _nprocs{ getNProcs( comm ) }
+  , _threaded{ threaded } {
+  if ( _threaded ) {
+    _thread = std::thread( &RemovalService::run, this );
+  }
+}
+
+RemovalService::~RemovalService() {
+  if ( _threaded ) {
+    {
+      std::lock_guard<std::mutex> lock( _mutex );
+      _stopping = true;
+    }
+    _changed.notify_all();
+    _thread.join();
+  }
+  // other ranks may still remove their share, a second pass picks up the rest
+  removeDirectories( true );
+  removeDirectories( true );
+}
+
+void RemovalService::enqueue( int step,
+                              const std::vector<std::string>& files,
+                              bool shared,
+                              const std::string& outputfile ) {
+  Job job{ step, {}, {}, now() };
+  if ( !shared ) {
+    job.files = files;
+  } else {
+    // one listing for all: a rank listing while another already removes
+    // would see a partial list, and the listing order is unspecified
+    std::vector<std::string> sorted;
+    if ( _rank == 0 ) {
+      sorted = files;
+      std::sort( sorted.begin(), sorted.end() );
+    }
+    sorted = BroadcastNames( sorted, _comm );
+
+    // striped, starting at another rank every step
+    for ( size_t i = 0; i < sorted.size(); ++i ) {
+      if ( static_cast<int>( ( i + static_cast<size_t>( step ) ) % static_cast<size_t>( _nprocs ) ) == _rank ) {
+        job.files.push_back( sorted[i] );
+      }
+    }
+    if ( step % _nprocs == _rank ) {
+      const std::filesystem::path top = std::filesystem::path( outputfile ).parent_path();
+      std::set<std::string> directories;
+      for ( const auto& file : sorted ) {
+        for ( auto path = std::filesystem::path( file ).parent_path();
+              !path.empty() && path != top && path != path.parent_path();
+              path = path.parent_path() ) {
+          directories.insert( path.string() );
+        }
+      }
+      job.directories.assign( directories.begin(), directories.end() );
+      std::sort( job.directories.begin(), job.directories.end(),
+                 []( const std::string& a, const std::string& b ) { return a.size() > b.size(); } );
+    }
+  }
+
+  if ( !_threaded ) {
+    process( job );
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+    _queue.push_back( std::move( job ) );
+  }
+  _changed.notify_all();
+}
+
+RemovalService::Report RemovalService::flush() {
+  std::unique_lock<std::mutex> lock( _mutex );
+  _changed.wait( lock, [ this ]() { return _queue.empty() && !_busy; } );
+  return _report;
+}
+
+void RemovalService::run() {
+  trace::threadName( "removal" );
+  for ( ;; ) {
+    std::unique_lock<std::mutex> lock( _mutex );
+    _changed.wait( lock, [ this ]() { return _stopping || !_queue.empty(); } );
+    if ( _queue.empty() ) {
+      return;
+    }
+    Job job = std::move( _queue.front() );
+    _queue.pop_front();
+    _busy = true;
+    lock.unlock();
+
+    process( job );
+
+    lock.lock();
+    _busy = false;
+    lock.unlock();
+    _changed.notify_all();
+  }
+}
+
+void RemovalService::process( const Job& job ) {
+  TraceScope scope( "unlink", "io", 0, job.step );
+  const double begin = now();
+  double removed = 0.0;
+  for ( const auto& file : job.files ) {
+    std::error_code ec;
+    if ( std::filesystem::remove( file, ec ) ) {
+      removed += 1.0;
+    }
+  }
+
+  std::lock_guard<std::mutex> lock( _mutex );
+  _leftover.insert( _leftover.end(), job.directories.begin(), job.directories.end() );
+  removeDirectories( false );
+  const double end = now();
+  _report.files += removed;
+  _report.busy += end - begin;
+  _report.maxLag = std::max( _report.maxLag, end - job.enqueued );
+}
+
+void RemovalService::removeDirectories( bool force ) {
+  std::vector<std::string> remaining;
+  for ( const auto& directory : _leftover ) {
+    std::error_code ec;
+    if ( force ) {
+      std::filesystem::remove_all( directory, ec );
+    } else {
+      std::filesystem::remove( directory, ec );
+    }
+    if ( ec && std::filesystem::exists( directory ) ) {
+      remaining.push_back( directory );
+    }
+  }
+  _leftover.swap( remaining );
+}
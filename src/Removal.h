@@ -0,0 +1,92 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * Removal.h
+ *
+ *  Created on: Oct 2026
+ *      Author: Gregor Weiss
+ *
+ *  Deferred deletion of old steps: every rank removes its share of the files
+ *  of a step, inline or on a background thread, so that checkpoint rotation
+ *  does not stall the solver.
+ */
+
+#ifndef REMOVAL_H_
+#define REMOVAL_H_
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <mpi.h>
+
+class RemovalService
+{
+ public:
+  // Per rank, over all steps removed so far
+  struct Report
+  {
+    double files{ 0.0 };
+    double busy{ 0.0 };   // seconds spent removing
+    double maxLag{ 0.0 }; // longest time from enqueue until a step was removed
+  };
+
+  // threaded: remove on a background thread, otherwise inline in enqueue.
+  // comm is used by enqueue only, on the calling thread
+  RemovalService( MPI_Comm comm, bool threaded );
+
+  // removes what is still queued
+  ~RemovalService();
+
+  RemovalService( RemovalService const& other ) = delete;
+
+  RemovalService& operator=( RemovalService const& other ) = delete;
+
+  // files: the files of this rank as named by the scheme, or if shared all
+  // files of the step, needed on rank 0 only, collective then.
+  // The files of a shared step are sorted and broadcast by rank 0, so that
+  // all ranks stripe the same list. Its directories below the directory of
+  // outputfile are removed once they are empty.
+  void enqueue( int step,
+                const std::vector<std::string>& files,
+                bool shared,
+                const std::string& outputfile );
+
+  // blocks until the queue is empty
+  Report flush();
+
+ private:
+  struct Job
+  {
+    int step;
+    std::vector<std::string> files;
+    std::vector<std::string> directories; // deepest first
+    double enqueued;
+  };
+
+  void run();
+
+  void process( const Job& job );
+
+  // removes the directories that became empty, the rest is tried again later
+  void removeDirectories( bool force );
+
+  MPI_Comm _comm;
+  int _rank;
+  int _nprocs;
+  bool _threaded;
+
+  std::mutex _mutex;
+  std::condition_variable _changed;
+  std::deque<Job> _queue{};
+  bool _busy{ false };
+  bool _stopping{ false };
+  std::vector<std::string> _leftover{};
+  Report _report{};
+  std::thread _thread{};
+};
+
+#endif /* REMOVAL_H_ */
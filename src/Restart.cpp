@@ -0,0 +1,122 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * Restart.cpp
+ *
+ *  Created on: Oct 2026
+ *      Author: Gregor Weiss
+ */
+
+#include "Restart.h"
+
+#include <algorithm>
+
+std::vector<Overlap> writerOverlaps( const Settings& s ) {
+  const std::array<unsigned int, 3> wnd{ s.wndx, s.wndy, s.wndz };
+  const std::array<unsigned int, 3> nd{ s.ndx, s.ndy, s.ndz };
+  const std::array<unsigned int, 3> offs{ s.offsx, s.offsy, s.offsz };
+
+  // range of writer positions touched by this reader in every dimension
+  std::array<unsigned int, 3> first, last;
+  for ( int d = 0; d < 3; ++d ) {
+    first[d] = offs[d] / wnd[d];
+    last[d] = ( offs[d] + nd[d] - 1 ) / wnd[d];
+  }
+
+  // loop in writer rank order, x is the fastest running position
+  std::vector<Overlap> overlaps;
+  for ( unsigned int pz = first[2]; pz <= last[2]; ++pz ) {
+    for ( unsigned int py = first[1]; py <= last[1]; ++py ) {
+      for ( unsigned int px = first[0]; px <= last[0]; ++px ) {
+        const std::array<unsigned int, 3> pos{ px, py, pz };
+        Overlap overlap;
+        overlap.rank = static_cast<int>( px + py * s.wnpx + pz * s.wnpx * s.wnpy );
+        for ( int d = 0; d < 3; ++d ) {
+          auto lower = std::max( offs[d], pos[d] * wnd[d] );
+          auto upper = std::min( offs[d] + nd[d], ( pos[d] + 1 ) * wnd[d] );
+          overlap.start[d] = lower - pos[d] * wnd[d];
+          overlap.memstart[d] = lower - offs[d];
+          overlap.count[d] = upper - lower;
+        }
+        overlaps.push_back( overlap );
+      }
+    }
+  }
+  return overlaps;
+}
+
+void forEachRun( const Overlap& overlap,
+                 const Settings& s,
+                 const std::function<void(std::size_t, std::size_t, std::size_t)>& fn ) {
+  std::size_t runFile = 0;
+  std::size_t runMem = 0;
+  std::size_t runLength = 0;
+  for ( unsigned int i = 0; i < overlap.count[0]; ++i ) {
+    for ( unsigned int j = 0; j < overlap.count[1]; ++j ) {
+      std::size_t file = ( static_cast<std::size_t>( overlap.start[0] + i ) * s.wndy
+                           + overlap.start[1] + j ) * s.wndz + overlap.start[2];
+      std::size_t mem = ( static_cast<std::size_t>( overlap.memstart[0] + i ) * s.ndy
+                          + overlap.memstart[1] + j ) * s.ndz + overlap.memstart[2];
+      if ( runLength > 0 && file == runFile + runLength && mem == runMem + runLength ) {
+        runLength += overlap.count[2];
+        continue;
+      }
+      if ( runLength > 0 ) {
+        fn( runFile, runMem, runLength );
+      }
+      runFile = file;
+      runMem = mem;
+      runLength = overlap.count[2];
+    }
+  }
+  if ( runLength > 0 ) {
+    fn( runFile, runMem, runLength );
+  }
+}
+
+void restartTypes( const Settings& s, MPI_Datatype& filetype, MPI_Datatype& memtype ) {
+  auto overlaps = writerOverlaps( s );
+  const MPI_Aint blockBytes = static_cast<MPI_Aint>( sizeof( double ) ) * s.wndx * s.wndy * s.wndz;
+  const MPI_Aint iterationBytes = static_cast<MPI_Aint>( sizeof( double ) ) * s.gndx * s.gndy * s.gndz;
+
+  int wsizes[3] = { static_cast<int>( s.wndx ), static_cast<int>( s.wndy ), static_cast<int>( s.wndz ) };
+  int sizes[3] = { static_cast<int>( s.ndx ), static_cast<int>( s.ndy ), static_cast<int>( s.ndz ) };
+
+  std::vector<MPI_Datatype> filetypes( overlaps.size() );
+  std::vector<MPI_Datatype> memtypes( overlaps.size() );
+  std::vector<MPI_Aint> filedisps( overlaps.size() );
+  std::vector<MPI_Aint> memdisps( overlaps.size(), 0 );
+  std::vector<int> blocklengths( overlaps.size(), 1 );
+  for ( size_t n = 0; n < overlaps.size(); ++n ) {
+    int subsizes[3] = { static_cast<int>( overlaps[n].count[0] ),
+                        static_cast<int>( overlaps[n].count[1] ),
+                        static_cast<int>( overlaps[n].count[2] ) };
+    int starts[3] = { static_cast<int>( overlaps[n].start[0] ),
+                      static_cast<int>( overlaps[n].start[1] ),
+                      static_cast<int>( overlaps[n].start[2] ) };
+    int memstarts[3] = { static_cast<int>( overlaps[n].memstart[0] ),
+                         static_cast<int>( overlaps[n].memstart[1] ),
+                         static_cast<int>( overlaps[n].memstart[2] ) };
+    MPI_Type_create_subarray( 3, wsizes, subsizes, starts, MPI_ORDER_C, MPI_DOUBLE, &filetypes[n] );
+    MPI_Type_create_subarray( 3, sizes, subsizes, memstarts, MPI_ORDER_C, MPI_DOUBLE, &memtypes[n] );
+    filedisps[n] = overlaps[n].rank * blockBytes;
+  }
+
+  // writer blocks are visited in rank order, so the file displacements are monotonic
+  MPI_Datatype blocks;
+  MPI_Type_create_struct( static_cast<int>( overlaps.size() ),
+                          blocklengths.data(), filedisps.data(), filetypes.data(), &blocks );
+  MPI_Type_create_resized( blocks, 0, iterationBytes, &filetype );
+  MPI_Type_commit( &filetype );
+  MPI_Type_free( &blocks );
+
+  MPI_Type_create_struct( static_cast<int>( overlaps.size() ),
+                          blocklengths.data(), memdisps.data(), memtypes.data(), &memtype );
+  MPI_Type_commit( &memtype );
+
+  for ( size_t n = 0; n < overlaps.size(); ++n ) {
+    MPI_Type_free( &filetypes[n] );
+    MPI_Type_free( &memtypes[n] );
+  }
+}
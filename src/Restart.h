@@ -0,0 +1,49 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * Restart.h
+ *
+ *  Created on: Oct 2026
+ *      Author: Gregor Weiss
+ *
+ *  Maps the subdomain of a reader onto the blocks written by a run
+ *  with a different process decomposition (see Settings::restart).
+ */
+
+#ifndef RESTART_H_
+#define RESTART_H_
+
+#include "Settings.h"
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <vector>
+#include <mpi.h>
+
+// Intersection of the reader's subdomain with the block of one writer rank.
+// All extents are given in (x, y, z) order like the local arrays.
+struct Overlap
+{
+  int rank;                            // writer rank owning the block
+  std::array<unsigned int, 3> start;   // first element relative to the writer block
+  std::array<unsigned int, 3> memstart; // first element relative to the reader block
+  std::array<unsigned int, 3> count;   // extent of the intersection
+};
+
+std::vector<Overlap> writerOverlaps( const Settings& s );
+
+// Calls fn( fileOffset, memOffset, length ) for every contiguous run of elements
+// of the overlap. fileOffset is relative to the writer block, memOffset to
+// the reader block. Runs that are contiguous in both are merged.
+void forEachRun( const Overlap& overlap,
+                 const Settings& s,
+                 const std::function<void(std::size_t, std::size_t, std::size_t)>& fn );
+
+// File and memory datatypes to read the reader's subdomain of one iteration
+// from a shared file that holds the writer blocks in rank order.
+// The filetype is resized to one iteration so that it tiles over iterations.
+void restartTypes( const Settings& s, MPI_Datatype& filetype, MPI_Datatype& memtype );
+
+#endif /* RESTART_H_ */
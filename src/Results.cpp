@@ -0,0 +1,209 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * Results.cpp
+ *
+ *  Created on: Oct 2026
+ *      Author: Gregor Weiss
+ */
+
+#include "Results.h"
+#include "Hints.h"
+#include "helper.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <filesystem>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+std::string timestamp() {
+  std::time_t now = std::chrono::system_clock::to_time_t( std::chrono::system_clock::now() );
+  std::tm utc;
+  gmtime_r( &now, &utc );
+  char buffer[32];
+  std::strftime( buffer, sizeof( buffer ), "%Y-%m-%dT%H:%M:%SZ", &utc );
+  return buffer;
+}
+
+// compiler, MPI library and the optional features compiled in
+std::string buildInfo() {
+  std::ostringstream info;
+#if defined( __clang__ )
+  info << "clang " << __clang_major__ << "." << __clang_minor__ << "." << __clang_patchlevel__;
+#elif defined( __GNUC__ )
+  info << "gcc " << __GNUC__ << "." << __GNUC_MINOR__ << "." << __GNUC_PATCHLEVEL__;
+#else
+  info << "unknown compiler";
+#endif
+  info << "; C++" << __cplusplus;
+
+  char library[MPI_MAX_LIBRARY_VERSION_STRING];
+  int length = 0;
+  MPI_Get_library_version( library, &length );
+  std::string mpi{ library, static_cast<size_t>( length ) };
+  info << "; " << mpi.substr( 0, mpi.find_first_of( ",\n" ) );
+
+#ifdef HAVE_SIONLIB
+  info << "; sionlib";
+#endif
+#ifdef HAVE_LZ4
+  info << "; lz4";
+#endif
+#ifdef HAVE_ZSTD
+  info << "; zstd";
+#endif
+#ifdef HAVE_ZFP
+  info << "; zfp";
+#endif
+#ifdef HAVE_INSTRUMENTATION
+  info << "; instrumentation";
+#endif
+  return info.str();
+}
+
+std::string jsonString( std::string_view value ) {
+  return JsonQuoted( std::string( value ) );
+}
+
+// JSON has no inf and nan
+std::string jsonNumber( double value ) {
+  if ( !std::isfinite( value ) ) {
+    return "null";
+  }
+  std::ostringstream number;
+  number.precision( 9 );
+  number << value;
+  return number.str();
+}
+
+constexpr const char* csvHeader =
+  "record,timestamp,run,phase,step,scheme,npx,npy,npz,ndx,ndy,ndz,iterations,nprocs,nodes,"
+  "compression,hints,bytes,min_s,avg_s,max_s,GBps,GiBps,build";
+
+} // namespace
+
+Results::Results( const Settings& s, MPI_Comm comm )
+  : _settings{ s }
+  , _communicator{ comm }
+  , _enabled{ !s.results.empty() } {
+  if ( !_enabled ) {
+    return;
+  }
+  _rank = getRank( comm );
+
+  // hosts: the first rank of every shared memory node counts
+  MPI_Comm node;
+  MPI_Comm_split_type( comm, MPI_COMM_TYPE_SHARED, _rank, MPI_INFO_NULL, &node );
+  int leader = getRank( node ) == 0 ? 1 : 0;
+  MPI_Allreduce( &leader, &_nodes, 1, MPI_INT, MPI_SUM, comm );
+  MPI_Comm_free( &node );
+  _build = buildInfo();
+
+  if ( _rank == 0 ) {
+    std::filesystem::path path{ s.results };
+    _csv = path.extension() == ".csv";
+    const bool fresh = !std::filesystem::exists( path ) || std::filesystem::file_size( path ) == 0;
+    // appended, so that the runs of a sweep share one file
+    _file.open( path, std::ios_base::out | std::ios_base::app );
+    if ( !_file ) {
+      throw std::runtime_error("Results: cannot open " + s.results);
+    }
+    _file.precision( 9 );
+    if ( _csv && fresh ) {
+      _file << csvHeader << "\n";
+    }
+  }
+}
+
+void Results::record( std::string_view phase, int step, double seconds, double bytes ) {
+  if ( !_enabled ) {
+    return;
+  }
+  double min = 0.0, sum = 0.0, max = 0.0;
+  MPI_Reduce( &seconds, &min, 1, MPI_DOUBLE, MPI_MIN, 0, _communicator );
+  MPI_Reduce( &seconds, &sum, 1, MPI_DOUBLE, MPI_SUM, 0, _communicator );
+  MPI_Reduce( &seconds, &max, 1, MPI_DOUBLE, MPI_MAX, 0, _communicator );
+  if ( _rank != 0 ) {
+    return;
+  }
+
+  write( "step", phase, step, bytes, min, sum / _settings.nproc, max, max );
+  // the warm-up steps are recorded but not summarised
+  if ( step <= static_cast<int>( _settings.warmup ) ) {
+    return;
+  }
+
+  auto aggregate = _aggregates.find( phase );
+  if ( aggregate == _aggregates.end() ) {
+    aggregate = _aggregates.emplace( std::string( phase ), Aggregate{ 0, max, 0.0, max, 0.0 } ).first;
+    _order.emplace_back( phase );
+  }
+  auto& a = aggregate->second;
+  a.steps += 1;
+  a.min = std::min( a.min, max );
+  a.sum += max;
+  a.max = std::max( a.max, max );
+  a.bytes += bytes;
+}
+
+void Results::summary( double runtime, unsigned int steps ) {
+  if ( !_enabled || _rank != 0 ) {
+    return;
+  }
+  // min/avg/max over the steps of the slowest rank's time, the rate over all steps
+  for ( const auto& phase : _order ) {
+    const auto& a = _aggregates.find( phase )->second;
+    write( "summary", phase, a.steps, a.bytes, a.min, a.sum / a.steps, a.max, a.sum );
+  }
+  write( "summary", "runtime", static_cast<int>( steps ), 0.0, runtime, runtime, runtime, runtime );
+  _file.flush();
+}
+
+void Results::write( std::string_view kind,
+                     std::string_view phase,
+                     int step,
+                     double bytes,
+                     double min,
+                     double avg,
+                     double max,
+                     double seconds ) {
+  const double GBps = bytes > 0.0 && seconds > 0.0 ? bytes / seconds * 1e-9 : 0.0;
+  const double GiBps = bytes > 0.0 && seconds > 0.0 ? bytes / seconds / ( 1024.0 * 1024.0 * 1024.0 ) : 0.0;
+  const auto& s = _settings;
+
+  if ( _csv ) {
+    _file << kind << "," << timestamp() << "," << s.run << "," << phase << "," << step << ","
+          << s.format << "," << s.npx << "," << s.npy << "," << s.npz << ","
+          << s.ndx << "," << s.ndy << "," << s.ndz << "," << s.iterations << ","
+          << s.nproc << "," << _nodes << "," << s.compression << ",\"" << toString( s.hints ) << "\","
+          << bytes << "," << min << "," << avg << "," << max << ","
+          << GBps << "," << GiBps << ",\"" << _build << "\"\n";
+  } else {
+    _file << "{\"record\":" << jsonString( kind )
+          << ",\"timestamp\":" << jsonString( timestamp() )
+          << ",\"run\":" << s.run
+          << ",\"phase\":" << jsonString( phase )
+          << ",\"step\":" << step
+          << ",\"scheme\":" << jsonString( s.format )
+          << ",\"decomposition\":[" << s.npx << "," << s.npy << "," << s.npz << "]"
+          << ",\"local\":[" << s.ndx << "," << s.ndy << "," << s.ndz << "]"
+          << ",\"iterations\":" << s.iterations
+          << ",\"nprocs\":" << s.nproc
+          << ",\"nodes\":" << _nodes
+          << ",\"compression\":" << jsonString( s.compression )
+          << ",\"hints\":" << jsonString( toString( s.hints ) )
+          << ",\"bytes\":" << jsonNumber( bytes )
+          << ",\"min_s\":" << jsonNumber( min )
+          << ",\"avg_s\":" << jsonNumber( avg )
+          << ",\"max_s\":" << jsonNumber( max )
+          << ",\"GBps\":" << jsonNumber( GBps )
+          << ",\"GiBps\":" << jsonNumber( GiBps )
+          << ",\"build\":" << jsonString( _build ) << "}\n";
+  }
+}
@@ -0,0 +1,76 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * Results.h
+ *
+ *  Created on: Oct 2026
+ *      Author: Gregor Weiss
+ *
+ *  Machine-readable results: one record per step and phase, reduced over all
+ *  ranks and appended by rank 0 to a JSON Lines file, or CSV if the file name
+ *  ends in .csv, followed by a summary per phase at the end of the run.
+ */
+
+#ifndef RESULTS_H_
+#define RESULTS_H_
+
+#include "Settings.h"
+
+#include <fstream>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <mpi.h>
+
+class Results
+{
+ public:
+  // collective, does nothing if s.results is empty
+  Results( const Settings& s, MPI_Comm comm );
+
+  Results( Results const& other ) = delete;
+
+  Results& operator=( Results const& other ) = delete;
+
+  bool enabled() const { return _enabled; }
+
+  // seconds of this rank, bytes moved by all ranks, collective
+  void record( std::string_view phase, int step, double seconds, double bytes );
+
+  // appends the aggregate of every phase and the runtime of the steps run, rank 0 only
+  void summary( double runtime, unsigned int steps );
+
+ private:
+  struct Aggregate
+  {
+    int steps{ 0 };
+    double min{ 0.0 };
+    double sum{ 0.0 };
+    double max{ 0.0 };
+    double bytes{ 0.0 };
+  };
+
+  void write( std::string_view kind,
+              std::string_view phase,
+              int step,
+              double bytes,
+              double min,
+              double avg,
+              double max,
+              double seconds );
+
+  const Settings& _settings;
+  MPI_Comm _communicator;
+  bool _enabled;
+  bool _csv{ false };
+  int _rank{ 0 };
+  int _nodes{ 1 };
+  std::string _build{};
+  std::ofstream _file{};
+  std::vector<std::string> _order{};
+  std::map<std::string, Aggregate, std::less<>> _aggregates{};
+};
+
+#endif /* RESULTS_H_ */
@@ -9,9 +9,11 @@
  */
 
 #include "Settings.h"
+#include "Hints.h"
 
 #include <errno.h>
 
+#include <algorithm>
 #include <cstdlib>
 
 #include <stdexcept>
@@ -36,9 +38,56 @@ static unsigned int convertToUint(std::string varName, char *arg)
     return static_cast<unsigned int>(retval);
 }
 
+static double convertToDouble(std::string varName, char *arg)
+{
+    char *end;
+    errno = 0;
+    double retval = std::strtod(arg, &end);
+    if (end == arg || end[0] || errno == ERANGE)
+    {
+        throw std::invalid_argument("Invalid value given for " + varName +
+                                    ": " + std::string(arg));
+    }
+    if (retval < 0)
+    {
+        throw std::invalid_argument("Negative value given for " + varName +
+                                    ": " + std::string(arg));
+    }
+    return retval;
+}
+
+static std::vector<std::string> split(const std::string &value, char separator)
+{
+    std::vector<std::string> items;
+    size_t begin = 0;
+    for (;;)
+    {
+        size_t end = value.find(separator, begin);
+        items.push_back(value.substr(begin, end - begin));
+        if (end == std::string::npos)
+        {
+            return items;
+        }
+        begin = end + 1;
+    }
+}
+
+// "NxMxL"
+static std::array<unsigned int, 3> convertToTriple(std::string varName, const std::string &value)
+{
+    auto items = split(value, 'x');
+    if (items.size() != 3)
+    {
+        throw std::invalid_argument("Invalid value given for " + varName + ": " + value);
+    }
+    return { convertToUint(varName, items[0].data()),
+             convertToUint(varName, items[1].data()),
+             convertToUint(varName, items[2].data()) };
+}
+
 Settings::Settings(int argc, char *argv[], int rank, int nproc) : rank{rank}
 {
-    if (argc < 9)
+    if (argc < 12)
     {
         throw std::invalid_argument("\nNot enough arguments\n");
     }
@@ -55,30 +104,203 @@ Settings::Settings(int argc, char *argv[], int rank, int nproc) : rank{rank}
     ndz = convertToUint("nz", argv[9]);
     steps = convertToUint("steps", argv[10]);
     iterations = convertToUint("iterations", argv[11]);
+    wnpx = npx;
+    wnpy = npy;
+    wnpz = npz;
 
-    if ( argc >= 13 ) {
-        if ( std::string(argv[12]) == std::string("read") ) {
-            read = true;
-        }
-        if ( std::string(argv[12]) == std::string("remove") ) {
-            remove = true;
-        }
-    }
+    // optional switches and key=value options following the positional arguments
+    for ( int i = 12; i < argc; ++i ) {
+        std::string option{ argv[i] };
+        auto pos = option.find( '=' );
+        std::string key{ option.substr( 0, pos ) };
+        std::string value{ pos == std::string::npos ? "" : option.substr( pos + 1 ) };
 
-    if ( argc >= 14 ) {
-        if ( std::string(argv[12]) == std::string("read")
-             ||
-             std::string(argv[13]) == std::string("read")) {
+        if ( key == "read" ) {
             read = true;
-        }
-        if ( std::string(argv[12]) == std::string("remove")
-             ||
-             std::string(argv[13]) == std::string("remove")) {
+        } else if ( key == "remove" ) {
+            remove = true;
+        } else if ( key == "keep" ) {
+            remove = true;
+            keep = convertToUint("keep", value.data());
+        } else if ( key == "removal" ) {
+            if ( value != "sync" && value != "async" ) {
+                throw std::invalid_argument("Invalid value given for removal: " + value);
+            }
             remove = true;
+            asyncRemove = ( value == "async" );
+        } else if ( key == "readonly" ) {
+            read = true;
+            readonly = true;
+        } else if ( key == "cold" ) {
+            cold = true;
+        } else if ( key == "prefetch" ) {
+            prefetch = true;
+        } else if ( key == "counters" ) {
+            counters = true;
+        } else if ( key == "streaming" ) {
+            streaming = true;
+        } else if ( key == "calibrate" ) {
+            calibrate = true;
+        } else if ( key == "warmup" ) {
+            warmup = convertToUint("warmup", value.data());
+        } else if ( key == "ci" ) {
+            ci = convertToDouble("ci", value.data());
+            if ( ci <= 0.0 || ci >= 1.0 ) {
+                throw std::invalid_argument("Invalid value given for ci: " + value);
+            }
+        } else if ( key == "maxsteps" ) {
+            maxSteps = convertToUint("maxsteps", value.data());
+        } else if ( key == "phases" ) {
+#ifndef HAVE_INSTRUMENTATION
+            throw std::invalid_argument("phases requires a build with -Dwith-instrumentation=ON");
+#endif
+            phases = true;
+        } else if ( key == "results" ) {
+            if ( value.empty() ) {
+                throw std::invalid_argument("Invalid value given for results: " + value);
+            }
+            results = value;
+        } else if ( key == "trace" ) {
+            if ( value.empty() ) {
+                throw std::invalid_argument("Invalid value given for trace: " + value);
+            }
+            trace = value;
+        } else if ( key == "hints" ) {
+            hints = parseHints( value );
+        } else if ( key == "sweep.schemes" ) {
+            sweepSchemes = split( value, ',' );
+        } else if ( key == "sweep.sizes" ) {
+            for ( const auto& size : split( value, ',' ) ) {
+                sweepSizes.push_back( convertToTriple( "sweep.sizes", size ) );
+            }
+        } else if ( key == "sweep.iterations" ) {
+            for ( auto& count : split( value, ',' ) ) {
+                sweepIterations.push_back( convertToUint( "sweep.iterations", count.data() ) );
+            }
+        } else if ( key == "sweep.hints" ) {
+            for ( const auto& set : split( value, '/' ) ) {
+                sweepHints.push_back( parseHints( set ) );
+            }
+        } else if ( key == "sweep.order" ) {
+            if ( value != "sequential" && value != "random" && value != "interleaved" ) {
+                throw std::invalid_argument("Invalid value given for sweep.order: " + value);
+            }
+            sweepOrder = value;
+        } else if ( key == "sweep.rounds" ) {
+            sweepRounds = convertToUint("sweep.rounds", value.data());
+            if ( sweepRounds == 0 ) {
+                throw std::invalid_argument("sweep.rounds must be greater than 0");
+            }
+        } else if ( key == "sweep.seed" ) {
+            sweepSeed = convertToUint("sweep.seed", value.data());
+        } else if ( key == "parameters" ) {
+            parameters = parseHints( value );
+        } else if ( key == "tune.schemes" ) {
+            tuneSchemes = split( value, ',' );
+        } else if ( key == "tune.hints" ) {
+            for ( const auto& set : split( value, '/' ) ) {
+                tuneHints.push_back( parseHints( set ) );
+            }
+        } else if ( key == "tune.parameters" ) {
+            for ( const auto& set : split( value, '/' ) ) {
+                tuneParameters.push_back( parseHints( set ) );
+            }
+        } else if ( key == "tune.aggregators" ) {
+            for ( auto& count : split( value, ',' ) ) {
+                tuneAggregators.push_back( convertToUint( "tune.aggregators", count.data() ) );
+            }
+        } else if ( key == "tune.chunks" ) {
+            for ( auto& bytes : split( value, ',' ) ) {
+                tuneChunks.push_back( convertToUint( "tune.chunks", bytes.data() ) );
+            }
+        } else if ( key == "tune.cache" ) {
+            tuneCache = value;
+        } else if ( key == "straggler" ) {
+            straggler = convertToDouble("straggler", value.data());
+        } else if ( key == "selection" ) {
+            if ( value != "box" && value != "block" ) {
+                throw std::invalid_argument("Invalid value given for selection: " + value);
+            }
+            boxSelection = ( value == "box" );
+        } else if ( key == "compression" ) {
+            compression = value;
+        } else if ( key == "shuffle" ) {
+            shuffle = value;
+        } else if ( key == "blocksize" ) {
+            blockSize = convertToUint("blocksize", value.data());
+        } else if ( key == "threads" ) {
+            threads = convertToUint("threads", value.data());
+        } else if ( key == "lossy" ) {
+            lossy = value;
+        } else if ( key == "tolerance" ) {
+            tolerance = convertToDouble("tolerance", value.data());
+        } else if ( key == "psnr" ) {
+            psnr = convertToDouble("psnr", value.data());
+        } else if ( key == "durability" ) {
+            if ( value != "none" && value != "close" && value != "fdatasync" && value != "fsync"
+                 && value != "range" && value != "mpi" ) {
+                throw std::invalid_argument("Invalid value given for durability: " + value);
+            }
+            durability = value;
+        } else if ( key == "data" ) {
+            if ( value != "stencil" && value != "constant" && value != "ramp" && value != "heat" && value != "random" ) {
+                throw std::invalid_argument("Invalid value given for data: " + value);
+            }
+            data = value;
+        } else if ( key == "seed" ) {
+            seed = convertToUint("seed", value.data());
+        } else if ( key == "delta" ) {
+            delta = value;
+        } else if ( key == "layout" ) {
+            if ( value != "rank" && value != "hashed" && value != "precreated" && value != "node" ) {
+                throw std::invalid_argument("Invalid value given for layout: " + value);
+            }
+            layout = value;
+        } else if ( key == "files" ) {
+            files = convertToUint("files", value.data());
+        } else if ( key == "slots" ) {
+            slots = convertToUint("slots", value.data());
+        } else if ( key == "timeout" ) {
+            timeout = convertToDouble("timeout", value.data());
+            if ( timeout <= 0.0 ) {
+                throw std::invalid_argument("Invalid value given for timeout: " + value);
+            }
+        } else if ( key == "stage" ) {
+            if ( value.empty() ) {
+                throw std::invalid_argument("Invalid value given for stage: " + value);
+            }
+            stage = value;
+        } else if ( key == "stagesteps" ) {
+            stageSteps = convertToUint("stagesteps", value.data());
+        } else if ( key == "verify" ) {
+            if ( value != "crc" && value != "none" ) {
+                throw std::invalid_argument("Invalid value given for verify: " + value);
+            }
+            verify = ( value == "crc" );
+        } else if ( key == "writer" ) {
+            auto first = value.find( 'x' );
+            auto second = value.find( 'x', first + 1 );
+            if ( first == std::string::npos || second == std::string::npos ) {
+                throw std::invalid_argument("Invalid value given for writer: " + value);
+            }
+            std::string wnx{ value.substr( 0, first ) };
+            std::string wny{ value.substr( first + 1, second - first - 1 ) };
+            std::string wnz{ value.substr( second + 1 ) };
+            wnpx = convertToUint("writer N", wnx.data());
+            wnpy = convertToUint("writer M", wny.data());
+            wnpz = convertToUint("writer L", wnz.data());
+            read = true;
+            readonly = true;
+        } else {
+            throw std::invalid_argument("Unknown option: " + option);
         }
     }
 
+    calculate();
+}
 
+void Settings::calculate()
+{
     if (npx * npy * npz != this->nproc)
     {
         throw std::invalid_argument("N*M*L must equal the number of processes");
@@ -96,6 +318,88 @@ Settings::Settings(int argc, char *argv[], int rank, int nproc) : rank{rank}
     globalGB  = global_bytes / std::pow( 10.0, 9 ) * static_cast<double>( iterations );
     localGiB  = local_bytes  / std::pow( 2.0, 30 ) * static_cast<double>( iterations );
     globalGiB = global_bytes / std::pow( 2.0, 30 ) * static_cast<double>( iterations );
+
+    // decomposition of the run that wrote the files to read
+    if ( wnpx == 0 || wnpy == 0 || wnpz == 0
+         || gndx % wnpx != 0 || gndy % wnpy != 0 || gndz % wnpz != 0 )
+    {
+        throw std::invalid_argument("writer decomposition must divide the global array");
+    }
+    wndx = gndx / wnpx;
+    wndy = gndy / wnpy;
+    wndz = gndz / wnpz;
+    restart = ( wnpx != npx || wnpy != npy || wnpz != npz );
+    if ( restart && ( compression != "none" || lossy != "none" || delta != "none" ) )
+    {
+        throw std::invalid_argument("writer= cannot be combined with compression");
+    }
+    if ( restart && layout == "node" )
+    {
+        throw std::invalid_argument("writer= cannot find the node folders of layout=node");
+    }
+    if ( lossy != "none" && tolerance == 0.0 && psnr == 0.0 )
+    {
+        throw std::invalid_argument("lossy= requires tolerance= or psnr=");
+    }
+    if ( format == "mdtest" && files == 0 )
+    {
+        throw std::invalid_argument("mdtest requires files > 0");
+    }
+    if ( verify && format == "mdtest" )
+    {
+        throw std::invalid_argument("verify=crc requires a scheme that writes the iterations, mdtest writes empty files");
+    }
+    if ( verify && ( restart || lossy != "none" ) )
+    {
+        throw std::invalid_argument("verify=crc requires the decomposition and exact data of the writer");
+    }
+    if ( !stage.empty() && ( compression != "none" || lossy != "none" || delta != "none" ) )
+    {
+        throw std::invalid_argument("stage= cannot be combined with compression");
+    }
+    // verify=crc stores the checksums in the ring for the consumer
+    if ( format == "shmstage" && ( read || readonly ) )
+    {
+        throw std::invalid_argument("shmstage cannot be read back, run the consumer to read the ring");
+    }
+    if ( !stage.empty() && ( format == "ascii" || format == "mdtest" || format == "shmstage" || stageSteps == 0 ) )
+    {
+        throw std::invalid_argument("stage= requires a scheme writing the iterations to files and stagesteps > 0");
+    }
+    if ( lossy != "none" && delta != "none" )
+    {
+        throw std::invalid_argument("delta= cannot be combined with lossy=");
+    }
+    autotune = !tuneSchemes.empty() || !tuneHints.empty() || !tuneParameters.empty()
+               || !tuneAggregators.empty() || !tuneChunks.empty();
+    if ( autotune && ( readonly || restart || !stage.empty() || keep > 0 ) )
+    {
+        throw std::invalid_argument("tune. options require writing every step once, without readonly, writer=, stage= or keep=");
+    }
+
+    if ( warmup >= steps )
+    {
+        throw std::invalid_argument("warmup= must leave steps to measure");
+    }
+    if ( ci > 0.0 && ( readonly || format == "shmstage" ) )
+    {
+        throw std::invalid_argument("ci= adds steps, which readonly and shmstage cannot");
+    }
+    if ( maxSteps == 0 )
+    {
+        maxSteps = 10 * steps;
+    }
+    maxSteps = std::max( maxSteps, steps );
+    if ( streaming && ( read || verify || !stage.empty() || autotune || data != "stencil" ) )
+    {
+        throw std::invalid_argument("streaming keeps no iterations to read back, verify, stage, tune or generate");
+    }
+    if ( streaming && ( format == "ascii" || format == "mdtest" || format == "sion" || format == "shmstage"
+                        || compression != "none" || lossy != "none" || delta != "none" ) )
+    {
+        throw std::invalid_argument("streaming requires an uncompressed adios2, binary, stream, level0, level1 or level3 scheme");
+    }
+
     posx = rank % npx;
     posy = ( rank / npx ) % npy;
     posz = rank / (npx * npy);
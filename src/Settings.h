@@ -11,7 +11,12 @@
 #ifndef SETTINGS_H_
 #define SETTINGS_H_
 
+#include <array>
 #include <string>
+#include <utility>
+#include <vector>
+
+using Hints = std::vector<std::pair<std::string, std::string> >;
 
 struct Settings
 {
@@ -29,6 +34,64 @@ struct Settings
     unsigned int iterations; // Number of computing iterations between steps
     bool read{ false };      // Switch to turn on re-reading
     bool remove{ false };    // Switch to turn on removal
+    bool asyncRemove{ false }; // Remove steps on a background thread
+    unsigned int keep{ 0 };  // Number of most recent steps not removed
+    bool readonly{ false };  // Switch to only re-read steps written by an earlier run
+    bool boxSelection{ false }; // ADIOS2: read by box selection instead of block ID
+    bool cold{ false };      // Switch to drop the files of a step from the page cache before reading
+    bool prefetch{ false };  // Switch to read the next iteration and step ahead
+    bool phases{ false };    // Switch to report the backend phases of every rank
+    double straggler{ 2.0 }; // Ranks slower than this multiple of the median are reported
+    std::string results{};   // File the records of every step and phase are appended to, CSV if *.csv
+    std::string trace{};     // Chrome trace file of the events of all ranks, written at the end of the job
+    bool counters{ false };  // Hardware counters of the compute and copy regions via perf_event_open
+    bool streaming{ false }; // Hand every iteration to the scheme right away instead of keeping the step
+    bool calibrate{ false }; // Measure memory, network and raw device ceilings once per job
+    unsigned int warmup{ 0 };   // First steps left out of the statistics
+    double ci{ 0.0 };           // Relative half width of the 95% CI to run steps until, 0: steps only
+    unsigned int maxSteps{ 0 }; // Most steps with ci, 0: ten times steps
+    Hints hints{};           // MPI-IO hints passed to MPI_File_open
+
+    // sweep: every combination of the lists runs in one job, an empty list keeps the argument
+    std::vector<std::string> sweepSchemes{};
+    std::vector<std::array<unsigned int, 3> > sweepSizes{};
+    std::vector<unsigned int> sweepIterations{};
+    std::vector<Hints> sweepHints{};
+    std::string sweepOrder{ "random" }; // Order of the runs in every round: sequential, random, interleaved
+    unsigned int sweepRounds{ 1 };      // Number of times every combination runs
+    unsigned int sweepSeed{ 1 };        // Seed of the random order, the same on all ranks
+    unsigned int run{ 0 };              // Index of this run in the sweep
+
+    Hints parameters{};      // ADIOS2 engine parameters set on top of the XML config
+
+    // autotune: candidates measured on the first steps, an empty list keeps the argument
+    std::vector<std::string> tuneSchemes{};
+    std::vector<Hints> tuneHints{};
+    std::vector<Hints> tuneParameters{};
+    std::vector<unsigned int> tuneAggregators{}; // cb_nodes of MPI-IO, NumAggregators of ADIOS2
+    std::vector<unsigned int> tuneChunks{};      // cb_buffer_size of MPI-IO, BufferChunkSize of ADIOS2
+    std::string tuneCache{};                     // File the choices are kept in for later runs
+    unsigned int wnpx;       // Number of writer processes in X dimension
+    unsigned int wnpy;       // Number of writer processes in Y dimension
+    unsigned int wnpz;       // Number of writer processes in Z dimension
+    std::string compression{ "none" }; // Lossless codec of the backends: none, lz4, zstd
+    std::string shuffle{ "byte" };     // Filter before compression: none, byte, bit
+    unsigned int blockSize{ 1 << 20 }; // Bytes per compressed block
+    unsigned int threads{ 1 };         // Number of compression and generator threads per process
+    std::string lossy{ "none" };       // Error-bounded stage before compression: none, quantize, zfp
+    double tolerance{ 0.0 };           // Absolute error bound of the lossy stage
+    double psnr{ 0.0 };                // Target PSNR in dB, tunes the tolerance if > 0
+    std::string durability{ "none" }; // Sync of written files: none, close, fdatasync, fsync, range, mpi
+    std::string data{ "stencil" };     // Iterations from the stencil or synthetic: constant, ramp, heat, random
+    unsigned int seed{ 1 };            // Seed of data=random
+    std::string delta{ "none" };       // Store iterations as delta to the previous one: none, xor, arith
+    bool verify{ false };              // Check read data against block checksums instead of the reference
+    std::string layout{ "rank" };      // Folders of binary_with_folders and mdtest: rank, hashed, precreated, node
+    unsigned int files{ 100 };         // Files per rank and step of mdtest
+    unsigned int slots{ 4 };           // Iterations the shmstage ring holds before the writer blocks
+    double timeout{ 60.0 };            // Seconds shmstage writer and consumer wait for each other
+    std::string stage{};               // Node-local directory steps are written to before they drain
+    unsigned int stageSteps{ 2 };      // Steps the staging directory holds before the writer blocks
 
     // calculated values from those arguments and number of processes
     unsigned int gndx; // Global array size in X dimension
@@ -38,6 +101,11 @@ struct Settings
     double globalGB;   // Global array size in GB
     double localGiB;    // Local array size in GiB
     double globalGiB;   // Global array size in GiB
+    unsigned int wndx;  // Local array size in X dimension per writer process
+    unsigned int wndy;  // Local array size in Y dimension per writer process
+    unsigned int wndz;  // Local array size in Z dimension per writer process
+    bool restart{ false }; // true: the files were written with another decomposition
+    bool autotune{ false }; // true: tune. options are given
     // X dim positions: rank 0, npx, 2npx... are in the same X position
     // Y dim positions: npx number of consecutive processes belong to one row
     // Z dim positions: npx*npy number of consecutive processes belong to one depth layer 
@@ -65,6 +133,10 @@ struct Settings
     bool async = false;
 
     Settings(int argc, char *argv[], int rank, int nproc);
+
+    // derives the calculated values from the user arguments and checks them,
+    // again after changing arguments
+    void calculate();
 };
 
 #endif /* SETTINGS_H_ */
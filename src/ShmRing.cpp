@@ -0,0 +1,278 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * ShmRing.cpp
+ *
+ *  Created on: Oct 2026
+ *      Author: Gregor Weiss
+ */
+
+#include "ShmRing.h"
+#include "Checksum.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+struct ShmRing::Header
+{
+  std::atomic<std::uint64_t> magic;       // stored last by the writer
+  std::uint64_t slots;
+  std::uint64_t slotBytes;                // data bytes per slot
+  std::uint64_t stride;                   // bytes from one slot to the next
+  alignas( 64 ) std::atomic<std::uint64_t> head; // slots published
+  alignas( 64 ) std::atomic<std::uint64_t> tail; // slots released
+  alignas( 64 ) std::atomic<std::uint32_t> closed;
+  std::atomic<std::int32_t> consumer;     // PID of the attached consumer, 0 before
+  std::int32_t writer;                    // PID of the creating writer
+};
+
+namespace {
+
+constexpr std::uint64_t ringMagic = 0x31474e4952504f48; // "HOPRING1"
+
+static_assert( std::atomic<std::uint64_t>::is_always_lock_free,
+               "the ring counters must be lock-free to live in shared memory" );
+
+// the slots start on their own cache lines behind the header
+constexpr std::size_t headerBytes = 256;
+
+// Seconds from now as a steady clock deadline
+std::chrono::steady_clock::time_point deadlineIn( double seconds ) {
+  return std::chrono::steady_clock::now()
+       + std::chrono::duration_cast<std::chrono::steady_clock::duration>( std::chrono::duration<double>( seconds ) );
+}
+
+bool exited( pid_t pid ) {
+  return pid != 0 && kill( pid, 0 ) != 0 && errno == ESRCH;
+}
+
+// Spins shortly, then yields the core while waiting for the other process
+template<typename Predicate>
+void waitUntil( Predicate ready ) {
+  for ( int spin = 0; !ready(); ++spin ) {
+    if ( spin < 1000 ) {
+      std::this_thread::yield();
+    } else {
+      std::this_thread::sleep_for( std::chrono::microseconds( 20 ) );
+    }
+  }
+}
+
+} // namespace
+
+ShmRing::~ShmRing() {
+  if ( _header == nullptr ) {
+    return;
+  }
+  if ( _owner ) {
+    close();
+  }
+  munmap( _header, _bytes );
+  if ( _owner ) {
+    // a consumer that mapped the segment keeps it until it unmaps
+    shm_unlink( _name.c_str() );
+  }
+}
+
+ShmRing::ShmRing( ShmRing&& other ) noexcept
+  : _header{ std::exchange( other._header, nullptr ) }
+  , _bytes{ std::exchange( other._bytes, 0 ) }
+  , _timeout{ std::exchange( other._timeout, 0.0 ) }
+  , _name{ std::move( other._name ) }
+  , _owner{ std::exchange( other._owner, false ) } {}
+
+ShmRing& ShmRing::operator=( ShmRing&& other ) noexcept {
+  ShmRing tmp{ std::move( other ) };
+  std::swap( _header, tmp._header );
+  std::swap( _bytes, tmp._bytes );
+  std::swap( _timeout, tmp._timeout );
+  std::swap( _name, tmp._name );
+  std::swap( _owner, tmp._owner );
+  return *this;
+}
+
+ShmRing ShmRing::create( const std::string& name, std::size_t slots, std::size_t slotBytes, double timeout ) {
+  if ( slots == 0 ) {
+    throw std::invalid_argument("ShmRing::create: at least one slot is required");
+  }
+  static_assert( sizeof( Header ) <= headerBytes, "ShmRing::Header outgrew its space" );
+  const std::size_t stride = ( sizeof( Slot ) + slotBytes + 63 ) / 64 * 64;
+
+  ShmRing ring;
+  ring._name = name;
+  ring._owner = true;
+  ring._timeout = timeout;
+  ring._bytes = headerBytes + slots * stride;
+
+  shm_unlink( name.c_str() );
+  int fd = shm_open( name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600 );
+  if ( fd < 0 ) {
+    throw std::runtime_error("ShmRing::create: shm_open failed for " + name);
+  }
+  if ( ftruncate( fd, static_cast<off_t>( ring._bytes ) ) != 0 ) {
+    ::close( fd );
+    shm_unlink( name.c_str() );
+    throw std::runtime_error("ShmRing::create: cannot size " + name);
+  }
+  void* address = mmap( nullptr, ring._bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+  ::close( fd );
+  if ( address == MAP_FAILED ) {
+    shm_unlink( name.c_str() );
+    throw std::runtime_error("ShmRing::create: mmap failed for " + name);
+  }
+
+  auto* header = new ( address ) Header;
+  header->slots = slots;
+  header->slotBytes = slotBytes;
+  header->stride = stride;
+  header->head.store( 0, std::memory_order_relaxed );
+  header->tail.store( 0, std::memory_order_relaxed );
+  header->closed.store( 0, std::memory_order_relaxed );
+  header->consumer.store( 0, std::memory_order_relaxed );
+  header->writer = static_cast<std::int32_t>( getpid() );
+  header->magic.store( ringMagic, std::memory_order_release );
+  ring._header = header;
+  return ring;
+}
+
+ShmRing ShmRing::attach( const std::string& name, double timeout ) {
+  const auto deadline = deadlineIn( timeout );
+  ShmRing ring;
+  ring._name = name;
+  ring._timeout = timeout;
+  for ( ;; ) {
+    int fd = shm_open( name.c_str(), O_RDWR, 0600 );
+    struct stat status;
+    if ( fd >= 0 && fstat( fd, &status ) == 0 && static_cast<std::size_t>( status.st_size ) > headerBytes ) {
+      ring._bytes = static_cast<std::size_t>( status.st_size );
+      void* address = mmap( nullptr, ring._bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+      ::close( fd );
+      if ( address == MAP_FAILED ) {
+        throw std::runtime_error("ShmRing::attach: mmap failed for " + name);
+      }
+      auto* header = static_cast<Header*>( address );
+      // a segment left behind by a writer that died is replaced by the next writer
+      if ( header->magic.load( std::memory_order_acquire ) == ringMagic && !exited( header->writer ) ) {
+        header->consumer.store( static_cast<std::int32_t>( getpid() ), std::memory_order_release );
+        ring._header = header;
+        return ring;
+      }
+      munmap( address, ring._bytes );
+    } else if ( fd >= 0 ) {
+      ::close( fd );
+    }
+    if ( std::chrono::steady_clock::now() > deadline ) {
+      throw std::runtime_error("ShmRing::attach: no writer created " + name);
+    }
+    std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+  }
+}
+
+std::string ShmRing::segmentName( const std::string& outputfile, int rank ) {
+  std::string name{ outputfile };
+  std::replace( name.begin(), name.end(), '/', '_' );
+  return "/" + name + ".shm." + std::to_string( rank );
+}
+
+std::int64_t ShmRing::now() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+           std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+std::size_t ShmRing::slots() const {
+  return _header == nullptr ? 0 : _header->slots;
+}
+
+std::size_t ShmRing::slotBytes() const {
+  return _header == nullptr ? 0 : _header->slotBytes;
+}
+
+char* ShmRing::slotAddress( std::uint64_t sequence ) const {
+  return reinterpret_cast<char*>( _header ) + headerBytes
+         + ( sequence % _header->slots ) * _header->stride;
+}
+
+double ShmRing::publish( std::uint64_t step,
+                         std::uint64_t iteration,
+                         const void* data,
+                         std::size_t bytes,
+                         bool checksum ) {
+  if ( bytes > _header->slotBytes ) {
+    throw std::invalid_argument("ShmRing::publish: iteration does not fit into a slot");
+  }
+  const std::uint64_t head = _header->head.load( std::memory_order_relaxed );
+  const std::int64_t handedOver = now();
+
+  // backpressure: wait for the consumer to release the oldest slot
+  const auto begin = std::chrono::steady_clock::now();
+  const auto deadline = deadlineIn( _timeout );
+  waitUntil( [ this, head, deadline ]()
+    {
+      if ( head - _header->tail.load( std::memory_order_acquire ) < _header->slots ) {
+        return true;
+      }
+      const pid_t consumer = _header->consumer.load( std::memory_order_acquire );
+      if ( exited( consumer ) ) {
+        throw std::runtime_error("ShmRing::publish: the consumer of " + _name + " exited");
+      }
+      if ( std::chrono::steady_clock::now() > deadline ) {
+        throw std::runtime_error( consumer == 0 ? "ShmRing::publish: no consumer attached to " + _name
+                                                : "ShmRing::publish: the consumer of " + _name + " released no slot in time" );
+      }
+      return false;
+    } );
+  const double waited = std::chrono::duration<double>( std::chrono::steady_clock::now() - begin ).count();
+
+  char* address = slotAddress( head );
+  std::memcpy( address + sizeof( Slot ), data, bytes );
+  Slot slot{ step, iteration, handedOver, checksum ? crc32c( data, bytes ) : 0u, checksum ? 1u : 0u };
+  std::memcpy( address, &slot, sizeof( slot ) );
+  _header->head.store( head + 1, std::memory_order_release );
+  return waited;
+}
+
+void ShmRing::close() {
+  _header->closed.store( 1, std::memory_order_release );
+}
+
+const ShmRing::Slot* ShmRing::next() {
+  const std::uint64_t tail = _header->tail.load( std::memory_order_relaxed );
+  const auto deadline = deadlineIn( _timeout );
+  waitUntil( [ this, tail, deadline ]()
+    {
+      if ( _header->head.load( std::memory_order_acquire ) > tail
+           || _header->closed.load( std::memory_order_acquire ) != 0 ) {
+        return true;
+      }
+      if ( exited( _header->writer ) ) {
+        throw std::runtime_error("ShmRing::next: the writer of " + _name + " exited");
+      }
+      if ( std::chrono::steady_clock::now() > deadline ) {
+        throw std::runtime_error("ShmRing::next: the writer of " + _name + " published nothing in time");
+      }
+      return false;
+    } );
+  // head is read again, slots published before closing are still delivered
+  if ( _header->head.load( std::memory_order_acquire ) <= tail ) {
+    return nullptr;
+  }
+  return reinterpret_cast<const Slot*>( slotAddress( tail ) );
+}
+
+void ShmRing::release() {
+  const std::uint64_t tail = _header->tail.load( std::memory_order_relaxed );
+  _header->tail.store( tail + 1, std::memory_order_release );
+}
@@ -0,0 +1,103 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * ShmRing.h
+ *
+ *  Created on: Oct 2026
+ *      Author: Gregor Weiss
+ *
+ *  Single-producer single-consumer ring buffer in POSIX shared memory. The
+ *  writer publishes one iteration per slot, the consumer processes the slot
+ *  in place and releases it. Both sides synchronise on two atomic sequence
+ *  counters only, each side also leaves its PID for the other to check:
+ *
+ *    [Header] [Slot 0 | data] ... [Slot n-1 | data]
+ */
+
+#ifndef SHMRING_H_
+#define SHMRING_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+class ShmRing
+{
+ public:
+  // Precedes the data of every slot
+  struct Slot
+  {
+    std::uint64_t step;
+    std::uint64_t iteration;
+    std::int64_t published; // handed to publish, steady clock in ns, the same on every process of a node
+    std::uint32_t crc;      // CRC32C of the data if checksummed is set
+    std::uint32_t checksummed;
+  };
+
+  ShmRing() = default;
+
+  ~ShmRing();
+
+  ShmRing( ShmRing const& other ) = delete;
+
+  ShmRing& operator=( ShmRing const& other ) = delete;
+
+  ShmRing( ShmRing&& other ) noexcept;
+
+  ShmRing& operator=( ShmRing&& other ) noexcept;
+
+  // Writer side, replaces an existing segment of that name. publish gives up
+  // after timeout seconds without a free slot.
+  static ShmRing create( const std::string& name, std::size_t slots, std::size_t slotBytes, double timeout );
+
+  // Consumer side, waits up to timeout seconds for the writer to create the
+  // segment, and next waits as long for a slot
+  static ShmRing attach( const std::string& name, double timeout );
+
+  // Name of the segment of a writer rank
+  static std::string segmentName( const std::string& outputfile, int rank );
+
+  // Steady clock in ns
+  static std::int64_t now();
+
+  bool valid() const { return _header != nullptr; }
+
+  std::size_t slots() const;
+
+  std::size_t slotBytes() const;
+
+  // Copies bytes into the next free slot, blocks while the ring is full
+  // (backpressure) and returns the seconds spent waiting. Throws if the
+  // consumer exited or no slot was released within the timeout.
+  double publish( std::uint64_t step,
+                  std::uint64_t iteration,
+                  const void* data,
+                  std::size_t bytes,
+                  bool checksum );
+
+  // No more slots will be published
+  void close();
+
+  // Next published slot, the data follows the Slot header. Blocks until one
+  // is available, returns nullptr once the ring is closed and drained. Throws
+  // if the writer exited or published nothing within the timeout.
+  const Slot* next();
+
+  // Hands the slot returned by next back to the writer
+  void release();
+
+ private:
+  struct Header;
+
+  char* slotAddress( std::uint64_t sequence ) const;
+
+  Header* _header{ nullptr };
+  std::size_t _bytes{ 0 };
+  double _timeout{ 0.0 };
+  std::string _name{};
+  bool _owner{ false };
+};
+
+#endif /* SHMRING_H_ */
@@ -0,0 +1,110 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * Statistics.cpp
+ *
+ *  Created on: Oct 2026
+ *      Author: Gregor Weiss
+ */
+
+#include "Statistics.h"
+#include "helper.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iostream>
+#include <numeric>
+
+namespace {
+
+// two-sided 97.5% quantiles of Student's t for 1 to 30 degrees of freedom
+constexpr std::array<double, 30> tQuantiles{
+  12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+  2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+  2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042 };
+
+double tQuantile( std::size_t degrees ) {
+  if ( degrees <= tQuantiles.size() ) {
+    return tQuantiles[degrees - 1];
+  }
+  // first order of the expansion around the normal quantile
+  constexpr double z = 1.959964;
+  return z + ( z * z * z + z ) / ( 4.0 * static_cast<double>( degrees ) );
+}
+
+} // namespace
+
+double Sample::median() const {
+  if ( _values.empty() ) {
+    return 0.0;
+  }
+  std::vector<double> sorted( _values );
+  std::sort( sorted.begin(), sorted.end() );
+  const std::size_t n = sorted.size();
+  return n % 2 == 1 ? sorted[n / 2] : 0.5 * ( sorted[n / 2 - 1] + sorted[n / 2] );
+}
+
+double Sample::mean() const {
+  if ( _values.empty() ) {
+    return 0.0;
+  }
+  return std::accumulate( _values.begin(), _values.end(), 0.0 ) / static_cast<double>( _values.size() );
+}
+
+double Sample::stddev() const {
+  if ( _values.size() < 2 ) {
+    return 0.0;
+  }
+  const double m = mean();
+  double squares = 0.0;
+  for ( double v : _values ) {
+    squares += ( v - m ) * ( v - m );
+  }
+  return std::sqrt( squares / static_cast<double>( _values.size() - 1 ) );
+}
+
+double Sample::halfWidth() const {
+  if ( _values.size() < 2 ) {
+    return 0.0;
+  }
+  return tQuantile( _values.size() - 1 ) * stddev() / std::sqrt( static_cast<double>( _values.size() ) );
+}
+
+bool Sample::converged( double target ) const {
+  return _values.size() >= 3 && halfWidth() <= target * mean();
+}
+
+void printStatistics( std::string_view identifier, const Sample& sample, double bytes ) {
+  if ( sample.count() == 0 ) {
+    return;
+  }
+  const double mean = sample.mean();
+  const double half = sample.halfWidth();
+  std::cout << identifier
+            << " steps " << sample.count()
+            << " median/mean/stddev [s] " << sample.median()
+            << " " << mean
+            << " " << sample.stddev()
+            << " 95% CI [s] " << mean - half << " " << mean + half
+            << " (+-" << ( mean > 0.0 ? 100.0 * half / mean : 0.0 ) << "%)";
+  if ( bytes > 0.0 && sample.median() > 0.0 ) {
+    std::cout << " perf at median [GB/s] " << bytes * 1e-9 / sample.median();
+  }
+  std::cout << "\n";
+}
+
+void printRankRates( std::string_view identifier, double seconds, double localBytes, MPI_Comm comm ) {
+  const double rate = seconds > 0.0 ? localBytes * 1e-9 / seconds : 0.0;
+  double min = 0.0, sum = 0.0, max = 0.0;
+  MPI_Reduce( &rate, &min, 1, MPI_DOUBLE, MPI_MIN, 0, comm );
+  MPI_Reduce( &rate, &sum, 1, MPI_DOUBLE, MPI_SUM, 0, comm );
+  MPI_Reduce( &rate, &max, 1, MPI_DOUBLE, MPI_MAX, 0, comm );
+  if ( getRank( comm ) == 0 ) {
+    std::cout << identifier
+              << " per rank [GB/s] min/avg/max " << min
+              << " " << sum / getNProcs( comm )
+              << " " << max << "\n";
+  }
+}
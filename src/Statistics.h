@@ -0,0 +1,58 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * Statistics.h
+ *
+ *  Created on: Oct 2026
+ *      Author: Gregor Weiss
+ *
+ *  Spread of the max. times of a phase over the steps of a run, for noisy
+ *  file systems where a single step says little: median, mean, standard
+ *  deviation and the 95% confidence interval of the mean (Student's t).
+ */
+
+#ifndef STATISTICS_H_
+#define STATISTICS_H_
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+#include <mpi.h>
+
+class Sample
+{
+ public:
+  void add( double value ) { _values.push_back( value ); }
+
+  // appends the values of another sample, e.g. of a repetition of the run
+  void add( const Sample& other ) { _values.insert( _values.end(), other._values.begin(), other._values.end() ); }
+
+  std::size_t count() const { return _values.size(); }
+
+  double median() const;
+
+  double mean() const;
+
+  // sample standard deviation, 0 below two values
+  double stddev() const;
+
+  // half width of the 95% confidence interval of the mean, 0 below two values
+  double halfWidth() const;
+
+  // the half width is at most target times the mean, needs three values
+  bool converged( double target ) const;
+
+ private:
+  std::vector<double> _values{};
+};
+
+// Rank 0 prints the statistics of a phase, with the rate of bytes at the
+// median if bytes > 0
+void printStatistics( std::string_view identifier, const Sample& sample, double bytes );
+
+// Rank 0 prints min/avg/max over the ranks of the rate of every rank,
+// localBytes over its own seconds, collective
+void printRankRates( std::string_view identifier, double seconds, double localBytes, MPI_Comm comm );
+
+#endif /* STATISTICS_H_ */
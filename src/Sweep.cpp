@@ -0,0 +1,84 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * Sweep.cpp
+ *
+ *  Created on: Oct 2026
+ *      Author: Gregor Weiss
+ */
+
+#include "Sweep.h"
+
+#include <algorithm>
+#include <array>
+#include <random>
+
+namespace {
+
+// an empty list keeps the value of the arguments
+template<typename T>
+std::vector<T> orDefault( const std::vector<T>& list, const T& value ) {
+  return list.empty() ? std::vector<T>{ value } : list;
+}
+
+} // namespace
+
+std::vector<Run> sweepRuns( const Settings& s ) {
+  const auto schemes = orDefault( s.sweepSchemes, s.format );
+  const auto sizes = orDefault( s.sweepSizes, std::array<unsigned int, 3>{ s.ndx, s.ndy, s.ndz } );
+  const auto iterations = orDefault( s.sweepIterations, s.iterations );
+  const auto hints = orDefault( s.sweepHints, s.hints );
+
+  std::vector<Settings> configurations;
+  for ( const auto& scheme : schemes ) {
+    for ( const auto& size : sizes ) {
+      for ( const auto& count : iterations ) {
+        for ( const auto& set : hints ) {
+          Settings c = s;
+          c.format = scheme;
+          c.ndx = size[0];
+          c.ndy = size[1];
+          c.ndz = size[2];
+          c.iterations = count;
+          c.hints = set;
+          c.calculate();
+          configurations.push_back( std::move( c ) );
+        }
+      }
+    }
+  }
+
+  // sequential: all rounds of a configuration before the next one,
+  // interleaved: every configuration once per round,
+  // random: every configuration once per round, shuffled every round
+  std::vector<Run> runs;
+  const auto n = static_cast<unsigned int>( configurations.size() );
+  if ( s.sweepOrder == "sequential" ) {
+    for ( unsigned int c = 0; c < n; ++c ) {
+      for ( unsigned int round = 0; round < s.sweepRounds; ++round ) {
+        runs.push_back( { configurations[c], c, round } );
+      }
+    }
+  } else {
+    std::vector<unsigned int> order( n );
+    for ( unsigned int c = 0; c < n; ++c ) {
+      order[c] = c;
+    }
+    for ( unsigned int round = 0; round < s.sweepRounds; ++round ) {
+      if ( s.sweepOrder == "random" ) {
+        // seeded identically on every rank, all ranks run the same configuration
+        std::mt19937 generator( s.sweepSeed + round );
+        std::shuffle( order.begin(), order.end(), generator );
+      }
+      for ( auto c : order ) {
+        runs.push_back( { configurations[c], c, round } );
+      }
+    }
+  }
+
+  for ( unsigned int r = 0; r < runs.size(); ++r ) {
+    runs[r].settings.run = r;
+  }
+  return runs;
+}
@@ -0,0 +1,33 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * Sweep.h
+ *
+ *  Created on: Oct 2026
+ *      Author: Gregor Weiss
+ *
+ *  Several configurations in one job: every combination of the sweep lists
+ *  of the settings runs sweepRounds times, in an order that spreads the
+ *  noise of the file system over the configurations.
+ */
+
+#ifndef SWEEP_H_
+#define SWEEP_H_
+
+#include "Settings.h"
+
+#include <vector>
+
+struct Run
+{
+  Settings settings;
+  unsigned int configuration; // index of the combination
+  unsigned int round;
+};
+
+// the runs in the order they are executed, a single run without sweep lists;
+// the same on all ranks, throws std::invalid_argument for invalid combinations
+std::vector<Run> sweepRuns( const Settings& s );
+
+#endif /* SWEEP_H_ */
@@ -0,0 +1,193 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * Trace.cpp
+ *
+ *  Created on: Oct 2026
+ *      Author: Gregor Weiss
+ */
+
+#include "Trace.h"
+#include "helper.h"
+
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace trace {
+
+bool enabled = false;
+
+namespace {
+
+struct Event
+{
+  const char* name;
+  const char* category;
+  double begin;
+  double end;
+  std::uint64_t bytes;
+  int step;
+};
+
+struct Buffer
+{
+  int thread;
+  std::string name;
+  std::vector<Event> events;
+};
+
+// the registry is locked only when a thread records its first event
+std::mutex registryMutex;
+std::vector<std::unique_ptr<Buffer> > registry;
+
+Buffer& buffer() {
+  thread_local Buffer* local = nullptr;
+  if ( local == nullptr ) {
+    std::lock_guard<std::mutex> lock( registryMutex );
+    const int thread = static_cast<int>( registry.size() );
+    registry.push_back( std::make_unique<Buffer>( Buffer{ thread, thread == 0 ? "main" : "thread " + std::to_string( thread ), {} } ) );
+    local = registry.back().get();
+    local->events.reserve( 4096 );
+  }
+  return *local;
+}
+
+// local clock at the start and the offsets to rank 0 at start and write
+double startTime = 0.0;
+double startOffset = 0.0;
+
+// offset of the local clock to the one of rank 0, the round trip with the
+// least time of a few ping-pongs per rank, collective
+double measureOffset( MPI_Comm comm ) {
+  const int rank = getRank( comm );
+  const int nprocs = getNProcs( comm );
+  constexpr int rounds = 8;
+  double offset = 0.0;
+  for ( int peer = 1; peer < nprocs; ++peer ) {
+    if ( rank == 0 ) {
+      for ( int round = 0; round < rounds; ++round ) {
+        double ping = 0.0;
+        MPI_Recv( &ping, 1, MPI_DOUBLE, peer, 0, comm, MPI_STATUS_IGNORE );
+        double reference = now();
+        MPI_Send( &reference, 1, MPI_DOUBLE, peer, 0, comm );
+      }
+    } else if ( rank == peer ) {
+      double best = std::numeric_limits<double>::max();
+      for ( int round = 0; round < rounds; ++round ) {
+        double sent = now();
+        double reference = 0.0;
+        MPI_Send( &sent, 1, MPI_DOUBLE, 0, 0, comm );
+        MPI_Recv( &reference, 1, MPI_DOUBLE, 0, 0, comm, MPI_STATUS_IGNORE );
+        double received = now();
+        if ( received - sent < best ) {
+          best = received - sent;
+          offset = reference - 0.5 * ( sent + received );
+        }
+      }
+    }
+  }
+  return offset;
+}
+
+} // namespace
+
+double now() {
+  return std::chrono::duration<double>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+void event( const char* name, const char* category, double begin, double end,
+            std::uint64_t bytes, int step ) {
+  buffer().events.push_back( { name, category, begin, end, bytes, step } );
+}
+
+void threadName( const char* name ) {
+  if ( enabled ) {
+    buffer().name = name;
+  }
+}
+
+void start( MPI_Comm comm ) {
+  MPI_Barrier( comm );
+  startOffset = measureOffset( comm );
+  startTime = now() + startOffset;
+  // the time line of every rank starts at the same time of rank 0
+  MPI_Bcast( &startTime, 1, MPI_DOUBLE, 0, comm );
+  buffer();
+  enabled = true;
+}
+
+void write( const std::string& filename, MPI_Comm comm ) {
+  enabled = false;
+  const int rank = getRank( comm );
+  const int nprocs = getNProcs( comm );
+  const double endLocal = now();
+  const double endOffset = measureOffset( comm );
+  const double startLocal = startTime - startOffset;
+
+  // the offset drifts linearly between the two measurements
+  auto global = [ & ]( double local )
+  {
+    const double span = endLocal - startLocal;
+    const double drift = span > 0.0 ? ( endOffset - startOffset ) * ( local - startLocal ) / span : 0.0;
+    return ( local + startOffset + drift - startTime ) * 1e6;
+  };
+
+  std::ostringstream out;
+  out.precision( 3 );
+  out << std::fixed;
+  if ( rank == 0 ) {
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+  } else {
+    out << ",\n";
+  }
+  out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << rank
+      << ",\"args\":{\"name\":\"rank " << rank << "\"}}";
+  out << ",\n{\"name\":\"process_sort_index\",\"ph\":\"M\",\"pid\":" << rank
+      << ",\"args\":{\"sort_index\":" << rank << "}}";
+  {
+    std::lock_guard<std::mutex> lock( registryMutex );
+    for ( const auto& b : registry ) {
+      out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << rank << ",\"tid\":" << b->thread
+          << ",\"args\":{\"name\":" << JsonQuoted( b->name ) << "}}";
+      for ( const auto& e : b->events ) {
+        const double begin = global( e.begin );
+        out << ",\n{\"name\":" << JsonQuoted( e.name ) << ",\"cat\":" << JsonQuoted( e.category )
+            << ",\"ph\":\"X\",\"pid\":" << rank << ",\"tid\":" << b->thread
+            << ",\"ts\":" << begin << ",\"dur\":" << global( e.end ) - begin
+            << ",\"args\":{\"bytes\":" << e.bytes;
+        if ( e.step >= 0 ) {
+          out << ",\"step\":" << e.step;
+        }
+        out << "}}";
+      }
+      b->events.clear();
+    }
+  }
+  if ( rank == nprocs - 1 ) {
+    out << "\n]}\n";
+  }
+
+  // the text of the ranks in rank order
+  const std::string text = out.str();
+  MPI_File fh;
+  if ( MPI_File_open( comm, filename.c_str(), MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &fh ) != MPI_SUCCESS ) {
+    if ( rank == 0 ) {
+      std::cout << "WARNING: cannot write the trace " << filename << std::endl;
+    }
+    return;
+  }
+  MPI_File_set_size( fh, 0 );
+  MPI_File_write_ordered( fh, text.data(), static_cast<int>( text.size() ), MPI_CHAR, MPI_STATUS_IGNORE );
+  MPI_File_close( &fh );
+  if ( rank == 0 ) {
+    std::cout << "Trace written to " << filename << "\n";
+  }
+}
+
+} // namespace trace
@@ -0,0 +1,78 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * Trace.h
+ *
+ *  Created on: Oct 2026
+ *      Author: Gregor Weiss
+ *
+ *  Timeline of the compute, exchange and I/O events of every rank and thread.
+ *  Every thread appends to a buffer of its own, so recording takes no lock;
+ *  at the end the buffers of all ranks are written in rank order into one
+ *  Chrome trace JSON file, with the clocks of the ranks aligned to rank 0.
+ *  Open it in chrome://tracing or https://ui.perfetto.dev.
+ */
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include <cstdint>
+#include <string>
+#include <mpi.h>
+
+namespace trace {
+
+// set by start, read on every event
+extern bool enabled;
+
+// seconds of the local steady clock
+double now();
+
+// appends an event to the buffer of the calling thread, name and category
+// must outlive the trace, e.g. string literals
+void event( const char* name, const char* category, double begin, double end,
+            std::uint64_t bytes = 0, int step = -1 );
+
+// names the track of the calling thread
+void threadName( const char* name );
+
+// enables recording and measures the clock offsets to rank 0, collective
+void start( MPI_Comm comm );
+
+// measures the clock offsets again and writes the events of all ranks to
+// filename, the buffers must not be written concurrently, collective
+void write( const std::string& filename, MPI_Comm comm );
+
+} // namespace trace
+
+// Records the lifetime of the object as an event
+class TraceScope
+{
+ public:
+  TraceScope( const char* name, const char* category, std::uint64_t bytes = 0, int step = -1 )
+    : _name{ name }
+    , _category{ category }
+    , _bytes{ bytes }
+    , _step{ step }
+    , _begin{ trace::enabled ? trace::now() : 0.0 } {}
+
+  ~TraceScope() {
+    if ( trace::enabled ) {
+      trace::event( _name, _category, _begin, trace::now(), _bytes, _step );
+    }
+  }
+
+  TraceScope( TraceScope const& other ) = delete;
+
+  TraceScope& operator=( TraceScope const& other ) = delete;
+
+ private:
+  const char* _name;
+  const char* _category;
+  std::uint64_t _bytes;
+  int _step;
+  double _begin;
+};
+
+#endif /* TRACE_H_ */
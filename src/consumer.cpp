@@ -0,0 +1,166 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * consumer.cpp
+ *
+ * In-situ consumer of the shmstage scheme: every rank maps the ring of the
+ * heatTransfer rank with the same number on the same node and processes the
+ * iterations in place. Synthetic data is validated against the generator,
+ * the stencil's iterations only by their checksums with verify=crc.
+ *
+ *  Created on: Oct 2026
+ *      Author: Gregor Weiss
+ *
+ */
+#include <mpi.h>
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Checksum.h"
+#include "Generator.h"
+#include "Metrics.h"
+#include "Settings.h"
+#include "ShmRing.h"
+
+void printUsage() {
+  std::cout << "Usage: consumer config.xml output shmstage N M L nx ny nz steps iterations [options]\n"
+            << "  Takes the arguments of the heatTransfer run to consume, started with\n"
+            << "  the same number of processes on the same nodes.\n"
+            << "  timeout=<s>: seconds writer and consumer wait for each other (default 60)\n\n";
+}
+
+int main( int argc, char* argv[] ) {
+
+  MPI_Init( &argc, &argv );
+
+  int rank, nproc;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank );
+  MPI_Comm_size(MPI_COMM_WORLD, &nproc );
+
+  try
+  {
+    Settings settings( argc, argv, rank, nproc );
+    ShmRing ring = ShmRing::attach( ShmRing::segmentName( settings.outputfile, rank ), settings.timeout );
+
+    const size_t count = static_cast<size_t>( settings.ndx ) * settings.ndy * settings.ndz;
+    // synthetic data depends only on the global index, the consumer generates it again
+    const bool synthetic = ( settings.data != "stencil" );
+    std::vector<std::vector<double> > expected;
+    for ( unsigned int t = 1; t <= settings.steps; ++t )
+    {
+      if ( synthetic ) {
+        generate( settings, t, expected );
+      }
+      ErrorMetrics values;
+      double latency[3] = { std::numeric_limits<double>::max(), 0.0, 0.0 }; // min, sum, max
+      unsigned long long counts[4] = { 0, 0, 0, 0 }; // iterations, checksum mismatches, out of order, failed
+      std::string error;
+      double measTime = MPI_Wtime();
+
+      for ( unsigned int it = 0; it < settings.iterations; ++it ) {
+        const ShmRing::Slot* slot = nullptr;
+        // a lost writer fails the step on all ranks below, not in the middle of the reductions
+        try {
+          slot = ring.next();
+        } catch ( std::runtime_error& e ) {
+          error = e.what();
+          counts[3] = 1;
+        }
+        if ( slot == nullptr ) {
+          break;
+        }
+        // zero copy: the data is processed where the writer put it
+        const auto* data = reinterpret_cast<const double*>( slot + 1 );
+        if ( synthetic ) {
+          const double* reference = expected[it].data();
+          for ( size_t i = 0; i < count; ++i ) {
+            values.add( reference[i], data[i] );
+          }
+        } else {
+          // the stencil is not recomputed here, only the value range is scanned
+          for ( size_t i = 0; i < count; ++i ) {
+            values.add( data[i], data[i] );
+          }
+        }
+        if ( slot->checksummed && crc32c( data, count * sizeof( double ) ) != slot->crc ) {
+          ++counts[1];
+        }
+        if ( slot->step != t || slot->iteration != it ) {
+          ++counts[2];
+        }
+        // from handing the iteration to the ring until it is processed
+        double seconds = static_cast<double>( ShmRing::now() - slot->published ) * 1e-9;
+        ring.release();
+
+        latency[0] = std::min( latency[0], seconds );
+        latency[1] += seconds;
+        latency[2] = std::max( latency[2], seconds );
+        ++counts[0];
+      }
+      measTime = MPI_Wtime() - measTime;
+
+      double maxTime = 0.0;
+      double minLatency = 0.0, sumLatency = 0.0, maxLatency = 0.0;
+      unsigned long long totals[4] = { 0, 0, 0, 0 };
+      MPI_Reduce( &measTime, &maxTime, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD );
+      MPI_Reduce( &latency[0], &minLatency, 1, MPI_DOUBLE, MPI_MIN, 0, MPI_COMM_WORLD );
+      MPI_Reduce( &latency[1], &sumLatency, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD );
+      MPI_Reduce( &latency[2], &maxLatency, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD );
+      MPI_Allreduce( counts, totals, 4, MPI_UNSIGNED_LONG_LONG, MPI_SUM, MPI_COMM_WORLD );
+      if ( totals[3] > 0 ) {
+        throw std::runtime_error( counts[3] > 0 ? error : "the writer of another rank is lost" );
+      }
+      auto global = values.reduce( MPI_COMM_WORLD, 0 );
+
+      if ( rank == 0 ) {
+        std::cout << "Consuming step " << t
+                  << " iterations " << totals[0]
+                  << " max. time [s] " << maxTime;
+        if ( totals[0] > 0 ) {
+          std::cout << " latency min/avg/max [s] " << minLatency
+                    << " " << sumLatency / static_cast<double>( totals[0] )
+                    << " " << maxLatency
+                    << " range " << global.min
+                    << " " << global.max;
+          if ( synthetic ) {
+            std::cout << " MSE " << global.mse()
+                      << " max. error " << global.maxAbsError;
+          }
+        }
+        std::cout << "\n";
+        if ( synthetic && global.maxAbsError > 0.0 ) {
+          std::cout << "WARNING: iterations do not match the generated data\n";
+        }
+        if ( totals[1] > 0 ) {
+          std::cout << "WARNING: " << totals[1] << " iterations do not match their checksum\n";
+        }
+        if ( totals[2] > 0 ) {
+          std::cout << "WARNING: " << totals[2] << " iterations arrived out of order\n";
+        }
+      }
+      // the writer closed its ring early
+      if ( totals[0] < static_cast<unsigned long long>( settings.iterations ) * nproc ) {
+        break;
+      }
+    }
+  }
+  catch ( std::invalid_argument& e ) // command-line argument errors
+  {
+    std::cout << e.what() << std::endl;
+    printUsage();
+  }
+  catch ( std::exception& e ) // All other exceptions
+  {
+    std::cout << "Exception caught\n";
+    std::cout << e.what() << std::endl;
+  }
+
+  MPI_Finalize();
+  return 0;
+}
@@ -11,22 +11,95 @@
 
 #include "helper.h"
 
+#include <atomic>
+#include <cstdio>
 #include <filesystem>
 #include <iostream>
+#include <thread>
+#include <vector>
 
-// Generate a folder per rank
-std::string MakeProcFolders( int rank ) {
-    std::filesystem::path path_name = "processor" + std::to_string(rank) + "/";
-    std::filesystem::create_directory( path_name );
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+// Name of the folder of a rank
+std::string ProcFolderName( int rank, const std::string &layout, int node ) {
+    if ( layout == "node" ) {
+      return "node" + std::to_string(node) + "/";
+    }
+    if ( layout == "hashed" ) {
+      // multiplicative hash, so that consecutive ranks land in different buckets
+      unsigned int bucket = ( static_cast<unsigned int>(rank) * 2654435761u ) >> 24;
+      char name[3];
+      std::snprintf( name, sizeof( name ), "%02x", bucket );
+      return "processors/" + std::string( name ) + "/processor" + std::to_string(rank) + "/";
+    }
+    return "processor" + std::to_string(rank) + "/";
+}
+
+int NodeIndex( MPI_Comm communicator ) {
+    MPI_Comm node, leaders;
+    MPI_Comm_split_type( communicator, MPI_COMM_TYPE_SHARED, getRank( communicator ), MPI_INFO_NULL, &node );
+    const bool leader = getRank( node ) == 0;
+    MPI_Comm_split( communicator, leader ? 0 : MPI_UNDEFINED, getRank( communicator ), &leaders );
+    int index = 0;
+    if ( leader ) {
+      index = getRank( leaders );
+      MPI_Comm_free( &leaders );
+    }
+    MPI_Bcast( &index, 1, MPI_INT, 0, node );
+    MPI_Comm_free( &node );
+    return index;
+}
+
+// Generate a folder per rank, per node or per rank in hashed buckets
+std::string MakeProcFolders( int rank, const std::string &layout, MPI_Comm communicator ) {
+    if ( layout == "node" ) {
+      MPI_Comm node;
+      MPI_Comm_split_type( communicator, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &node );
+      std::filesystem::path path_name = ProcFolderName( rank, layout, NodeIndex( communicator ) );
+      if ( getRank( node ) == 0 ) {
+        std::filesystem::create_directory( path_name );
+      }
+      MPI_Barrier( node );
+      MPI_Comm_free( &node );
+      return path_name.string();
+    }
+    if ( layout == "precreated" ) {
+      if ( rank == 0 ) {
+        for ( int r = 0; r < getNProcs( communicator ); ++r ) {
+          std::filesystem::create_directory( ProcFolderName( r ) );
+        }
+      }
+      MPI_Barrier( communicator );
+      return ProcFolderName( rank );
+    }
+    std::filesystem::path path_name = ProcFolderName( rank, layout );
+    std::filesystem::create_directories( path_name );
     return path_name.string();
 }
 
 // Remove processor folders
-void RemoveProcFolders( int rank ) {
-    std::filesystem::path path_name = "processor" + std::to_string(rank) + "/";
+void RemoveProcFolders( int rank, const std::string &layout, MPI_Comm communicator ) {
+    std::error_code ec;
+    if ( layout == "node" ) {
+      MPI_Barrier( communicator );
+      std::filesystem::remove( ProcFolderName( rank, layout, NodeIndex( communicator ) ), ec );
+      return;
+    }
+    std::filesystem::path path_name = ProcFolderName( rank, layout );
     if( std::filesystem::exists( path_name ) ) {
       std::filesystem::remove( path_name );
     }
+    if ( layout == "hashed" ) {
+      MPI_Barrier( communicator );
+      if ( rank == 0 && std::filesystem::is_directory( "processors" ) ) {
+        for ( const auto& bucket : std::filesystem::directory_iterator( "processors" ) ) {
+          std::filesystem::remove( bucket.path(), ec );
+        }
+        std::filesystem::remove( "processors", ec );
+      }
+    }
 }
 
 // Generate a file name from the outputfile string and the arguments
@@ -75,6 +148,79 @@ std::string& insertIndexIfRequired( std::string& name,
     return name;
 }
 
+// Missing files are skipped, not every rank owns a file of every step
+void EvictFromCache( const std::string &filename )
+{
+    int fd = open( filename.c_str(), O_RDONLY );
+    if ( fd < 0 )
+    { return; }
+    fsync( fd );
+    posix_fadvise( fd, 0, 0, POSIX_FADV_DONTNEED );
+    close( fd );
+}
+
+void AdviseWillNeed( int fd, long long offset, long long length )
+{
+    posix_fadvise( fd, static_cast<off_t>( offset ), static_cast<off_t>( length ), POSIX_FADV_WILLNEED );
+}
+
+void AdviseWillNeed( const std::string &filename,
+                     long long offset /* = 0 */,
+                     long long length /* = 0 */ )
+{
+    int fd = open( filename.c_str(), O_RDONLY );
+    if ( fd < 0 )
+    { return; }
+    AdviseWillNeed( fd, offset, length );
+    close( fd );
+}
+
+double PeakResidentBytes() {
+  struct rusage usage;
+  getrusage( RUSAGE_SELF, &usage );
+  // kilobytes on Linux
+  return static_cast<double>( usage.ru_maxrss ) * 1024.0;
+}
+
+// packed into one buffer, separated by '\0'
+std::vector<std::string> BroadcastNames( const std::vector<std::string> &names, MPI_Comm communicator ) {
+  std::string packed;
+  if ( getRank( communicator ) == 0 ) {
+    for ( const auto& name : names ) {
+      packed += name;
+      packed += '\0';
+    }
+  }
+  unsigned long long length = packed.size();
+  MPI_Bcast( &length, 1, MPI_UNSIGNED_LONG_LONG, 0, communicator );
+  packed.resize( length );
+  MPI_Bcast( packed.data(), static_cast<int>( length ), MPI_CHAR, 0, communicator );
+
+  std::vector<std::string> result;
+  for ( size_t begin = 0, end; begin < packed.size(); begin = end + 1 ) {
+    end = packed.find( '\0', begin );
+    result.push_back( packed.substr( begin, end - begin ) );
+  }
+  return result;
+}
+
+std::string JsonQuoted( const std::string &value ) {
+  std::string quoted{ "\"" };
+  for ( char c : value ) {
+    if ( c == '"' || c == '\\' ) {
+      quoted += '\\';
+      quoted += c;
+    } else if ( static_cast<unsigned char>( c ) < 0x20 ) {
+      char escaped[8];
+      std::snprintf( escaped, sizeof( escaped ), "\\u%04x", static_cast<unsigned int>( c ) );
+      quoted += escaped;
+    } else {
+      quoted += c;
+    }
+  }
+  return quoted + "\"";
+}
+
 int getRank( MPI_Comm communicator )
 {
   int rank;
@@ -89,3 +235,23 @@ int getNProcs( MPI_Comm communicator )
   return size;
 }
 
+// Runs fn( n ) for n in [0, count) on a pool of threads
+void parallelFor( std::size_t count,
+                  unsigned int threads,
+                  const std::function<void(std::size_t)>& fn ) {
+  std::atomic<std::size_t> next{ 0 };
+  auto worker = [ &next, count, &fn ]()
+  {
+    for ( std::size_t n = next++; n < count; n = next++ ) {
+      fn( n );
+    }
+  };
+  std::vector<std::thread> pool;
+  for ( unsigned int t = 1; t < threads; ++t ) {
+    pool.emplace_back( worker );
+  }
+  worker();
+  for ( auto& thread : pool ) {
+    thread.join();
+  }
+}
@@ -11,12 +11,30 @@
 #ifndef HELPER_H_
 #define HELPER_H_
 
+#include <cstddef>
+#include <functional>
 #include <string>
+#include <vector>
 #include <mpi.h>
 
-std::string MakeProcFolders( int rank );
+// Folder of a rank in a layout: rank (processorN/), hashed (processors/hh/processorN/),
+// precreated (processorN/, made by rank 0) or node (nodeK/ of the node K the rank runs on)
+std::string ProcFolderName( int rank,
+                            const std::string &layout = "rank",
+                            int node = 0 );
 
-void RemoveProcFolders( int rank );
+// Index of the node this process runs on, collective
+int NodeIndex( MPI_Comm communicator );
+
+// Creates the folder of this rank, collective
+std::string MakeProcFolders( int rank,
+                             const std::string &layout,
+                             MPI_Comm communicator );
+
+// Removes the folder of this rank and the shared parents once they are empty, collective
+void RemoveProcFolders( int rank,
+                        const std::string &layout,
+                        MPI_Comm communicator );
 
 std::string MakeFilename( const std::string &outputfile,
                           const std::string &suffix,
@@ -30,6 +48,31 @@ std::string& insertIndexIfRequired( std::string& name,
                                     size_t pos,
                                     int index );
 
+// Flushes a file and drops its pages from the page cache
+void EvictFromCache( const std::string &filename );
+
+// Asks the kernel to read a byte range ahead, length 0 means up to the end
+void AdviseWillNeed( int fd, long long offset, long long length );
+
+void AdviseWillNeed( const std::string &filename,
+                     long long offset = 0,
+                     long long length = 0 );
+
+// Runs fn( n ) for n in [0, count) on a pool of threads
+void parallelFor( std::size_t count,
+                  unsigned int threads,
+                  const std::function<void(std::size_t)>& fn );
+
+// Largest resident set of the process so far in bytes
+double PeakResidentBytes();
+
+// The names given on rank 0, on every rank, collective
+std::vector<std::string> BroadcastNames( const std::vector<std::string> &names,
+                                         MPI_Comm communicator );
+
+// value as a JSON string in quotes, with quotes, backslashes and control characters escaped
+std::string JsonQuoted( const std::string &value );
+
 int getRank( MPI_Comm communicator );
 
 int getNProcs( MPI_Comm communicator );
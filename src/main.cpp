@@ -15,6 +15,8 @@
  */
 #include <mpi.h>
 
+#include <algorithm>
+#include <optional>
 #include <iostream>
 #include <stdexcept>
 #include <string>
@@ -25,9 +27,24 @@
 #include <ctime>
 
 #include "helper.h"
+#include "Autotune.h"
+#include "Calibration.h"
+#include "Checksum.h"
+#include "Compression.h"
+#include "Counters.h"
+#include "Durability.h"
+#include "Footprint.h"
+#include "Generator.h"
 #include "HeatTransfer.h"
+#include "Hints.h"
 #include "IO.h"
+#include "Instrumentation.h"
+#include "Metrics.h"
+#include "Results.h"
 #include "Settings.h"
+#include "Statistics.h"
+#include "Sweep.h"
+#include "Trace.h"
 
 #include "ndarray.h"
 
@@ -43,19 +60,76 @@ void printUsage() {
             << "  ny:     local array size in Y dimension per processor\n"
             << "  nz:     local array size in Z dimension per processor\n"
             << "  steps:  the total number of steps to output\n"
-            << "  iterations: one step consist of this many iterations\n\n"
+            << "  iterations: one step consist of this many iterations\n"
+            << "Options:\n"
+            << "  read:     re-read every step after writing it\n"
+            << "  remove:   remove every step after writing (and reading) it\n"
+            << "  keep=<K>: keep the last K steps, remove older ones (implies remove)\n"
+            << "  removal=sync|async: remove steps inline or on a background thread (implies remove)\n"
+            << "  readonly: skip calculation and writing, only read existing steps\n"
+            << "  selection=block|box: ADIOS2 read by writer block ID or by box\n"
+            << "  results=<file>: append a JSON Lines record per step and phase, CSV if the file ends in .csv\n"
+            << "  trace=<file>: write a Chrome trace of the compute, exchange and I/O events of all ranks\n"
+            << "  counters: report cycles, instructions and cache misses of the compute and copy regions\n"
+            << "  streaming: write every iteration when it is computed instead of keeping the step\n"
+            << "  warmup=<n>: steps left out of the statistics and the results summary (default 0)\n"
+            << "  ci=<fraction>: add steps until the 95% CI of every phase is within fraction of its mean\n"
+            << "  maxsteps=<n>: most steps ci= may run (default 10 times steps)\n"
+            << "  calibrate: measure memory, MPI and raw O_DIRECT device ceilings once and report rates against them\n"
+            << "  hints=<key=value,...>: MPI-IO hints of the mpiio schemes\n"
+            << "  sweep.schemes=<a,b,...>: run every listed scheme in this job\n"
+            << "  sweep.sizes=<nxxnyxnz,...>: run every listed local array size\n"
+            << "  sweep.iterations=<n,...>: run every listed number of iterations\n"
+            << "  sweep.hints=<hints/hints/...>: run every listed hint set, none for no hints\n"
+            << "  sweep.order=sequential|interleaved|random: order of the runs (default random)\n"
+            << "  sweep.rounds=<n>: times every combination runs (default 1)\n"
+            << "  sweep.seed=<n>: seed of the random order (default 1)\n"
+            << "  parameters=<key=value,...>: ADIOS2 engine parameters on top of the XML config\n"
+            << "  tune.schemes=<a,b,...>: schemes the autotuner measures on the first steps\n"
+            << "  tune.hints=<hints/hints/...>: MPI-IO hint sets the autotuner measures\n"
+            << "  tune.parameters=<parameters/parameters/...>: ADIOS2 parameter sets the autotuner measures\n"
+            << "  tune.aggregators=<n,...>: aggregator counts the autotuner measures\n"
+            << "  tune.chunks=<bytes,...>: collective buffer or chunk sizes the autotuner measures\n"
+            << "  tune.cache=<file>: keep the choice per processes and bytes per rank for later runs\n"
+            << "  phases:   report the phases of the backends per rank (needs -Dwith-instrumentation=ON)\n"
+            << "  straggler=<factor>: report ranks slower than factor times the median (default 2)\n"
+            << "  cold:     drop the files of a step from the page cache before reading it\n"
+            << "  prefetch: read the next iteration (and in readonly the next step) ahead\n"
+            << "  writer=NxMxL: read steps written with another decomposition (implies readonly)\n"
+            << "  compression=none|lz4|zstd: compress binary, stream and MPI-IO output\n"
+            << "  shuffle=none|byte|bit: filter applied before compression (default byte)\n"
+            << "  blocksize=<bytes>: size of the compressed blocks (default 1 MiB)\n"
+            << "  threads=<n>: compression and generator threads per process (default 1)\n"
+            << "  durability=none|close|fdatasync|fsync|range|mpi: sync written files before the write ends\n"
+            << "  data=stencil|constant|ramp|heat|random: compute the iterations or generate them (I/O only)\n"
+            << "  seed=<n>: seed of data=random (default 1)\n"
+            << "  lossy=none|quantize|zfp: error-bounded stage before compression\n"
+            << "  tolerance=<value>: absolute error bound of the lossy stage\n"
+            << "  psnr=<dB>: tune the tolerance on the first step to reach this PSNR\n"
+            << "  delta=none|xor|arith: store iterations as delta to the previous one\n"
+            << "  verify=crc: check read data against CRC32C block checksums written with it\n"
+            << "  layout=rank|hashed|precreated|node: folders of binary_with_folders and mdtest\n"
+            << "  files=<n>: files per rank and step of mdtest, at least 1 (default 100)\n"
+            << "  slots=<n>: iterations the shmstage ring holds (default 4)\n"
+            << "  timeout=<s>: seconds the shmstage writer and consumer wait for each other (default 60)\n"
+            << "  stage=<dir>: write steps to a node-local directory and drain them in the background\n"
+            << "  stagesteps=<n>: steps the staging directory holds (default 2)\n\n"
             << "Note that N*M*L must be equal to the number of MPI processes.\n\n";
 }
 
 
-void printPerf( std::string_view identifier, const double timing, const Settings& settings ) {
+// ceiling: GB/s the rate is given as a share of, if > 0
+void printPerf( std::string_view identifier, const double timing, const Settings& settings, double ceiling = 0.0 ) {
   auto now = std::chrono::system_clock::now();
   std::time_t now_time = std::chrono::system_clock::to_time_t(now);
   std::cout << identifier
             << " max. time [s] " << timing
             << " perf [GB/s] " << settings.globalGB / timing
-            << " perf [GiB/s] " << settings.globalGiB / timing
-            << "\n";
+            << " perf [GiB/s] " << settings.globalGiB / timing;
+  if ( ceiling > 0.0 ) {
+    std::cout << " of ceiling [%] " << 100.0 * settings.globalGB / timing / ceiling;
+  }
+  std::cout << "\n";
   std::cout << "    finished at " << std::ctime(&now_time);
 }
 
@@ -79,155 +153,478 @@ void checkEquality( std::vector<std::vector<double> >& input1,
 }
 
 
-void peakSignalToNoise( std::vector<double>& ref,
-                        std::vector<double>& org ) {
-  auto peakVal = std::numeric_limits<double>::lowest();
-  double mse = 0;
-  double psnr = 0;
+void printMetrics( std::string_view identifier, const ErrorMetrics& metrics ) {
+  std::cout << identifier
+            << " min " << metrics.min
+            << " max " << metrics.max
+            << " MSE " << metrics.mse()
+            << " max. error " << metrics.maxAbsError
+            << " PSNR [dB] " << metrics.psnr()
+            << "\n";
+}
 
-  auto minVal = std::numeric_limits<double>::max();
-  auto maxVal = std::numeric_limits<double>::lowest();
 
-  for ( size_t i = 0; i < ref.size(); ++i ) {
-    minVal = std::min(minVal, ref[i]);
-    maxVal = std::max(maxVal, ref[i]);
-    double sum = ref[i] - org[i];
-    mse += sum * sum;
+// max. times of the steps after the warm-up, rank 0 only
+struct Samples
+{
+  Sample compute, write, read;
+};
+
+// one configuration: calculation, output and re-reading of all steps,
+// returns the samples of the phases
+Samples run( const Settings& arguments, const Ceilings& ceilings, int rank ) {
+  double measTime = 0.0; // individual processor timing
+  double maxTime = 0.0;  // reduced maximum timing
+  double totalTime = MPI_Wtime();
+
+  // the autotuner replaces scheme, hints and parameters with the fastest candidate after every rung
+  Autotuner tuner( arguments, MPI_COMM_WORLD );
+  Settings settings = tuner.choice();
+  HeatTransfer ht( settings );
+  Results results( settings, MPI_COMM_WORLD );
+  // mdtest moves no payload
+  auto payloadBytes = [ &settings ]() { return settings.format == "mdtest" ? 0.0 : settings.globalGB * 1e9; };
+  std::optional<IO<IOVariant> > io;
+  io.emplace( settings, MPI_COMM_WORLD );
+  io->chooseFormat( settings.format );
+
+  if ( settings.counters ) {
+    const std::string available = counters::start();
+    if ( rank == 0 ) {
+      std::cout << "Counters " << available << "\n";
+    }
   }
-  peakVal = std::max(peakVal, maxVal - minVal);
-  mse /= static_cast<double>(ref.size());
-  psnr = 20 * log10(peakVal/(2 * sqrt(mse)));
-  
-  std::cout << "MSE : " << mse << std::endl;
-  std::cout << "PSNR : " << psnr << std::endl;
-}
 
+  ht.init( false );
+  ht.exchange(MPI_COMM_WORLD);
 
-int main( int argc, char* argv[] ) {
-  
-  MPI_Init( &argc, &argv );
-  
-  int rank, nproc;
-  MPI_Comm_rank(MPI_COMM_WORLD, &rank );
-  MPI_Comm_size(MPI_COMM_WORLD, &nproc );
+  Samples samples;
+  Sample& computeSample = samples.compute;
+  Sample& writeSample = samples.write;
+  Sample& readSample = samples.read;
+  // with ci= steps are added until the confidence intervals are tight enough
+  unsigned int lastStep = settings.steps;
 
-  try
+  for ( unsigned int t = 1; t <= lastStep; ++t )
   {
-    double measTime = 0.0; // individual processor timing
-    double maxTime = 0.0;  // reduced maximum timing
-    double totalTime = MPI_Wtime();
+    // storage bytes of the process since the start of a phase
+    StorageTraffic traffic = StorageTraffic::now();
 
-    Settings settings( argc, argv, rank, nproc );
-    HeatTransfer ht( settings );
-    IO<IOVariant> io( settings, MPI_COMM_WORLD);
-    io.chooseFormat( settings.format );
-
-    ht.init( false );
-    ht.exchange(MPI_COMM_WORLD);
-
-    for ( unsigned int t = 1; t <= settings.steps; ++t )
-    {
+    if ( !settings.readonly ) {
       MPI_Barrier(MPI_COMM_WORLD);
       measTime = MPI_Wtime();
-
-      ht.m_TIterations.clear();
-      for ( unsigned int iter = 1; iter <= settings.iterations; ++iter )
-      {
-        ht.iterate();
-        ht.exchange(MPI_COMM_WORLD);
-        ht.store();
+      double writeTime = 0.0; // streaming: the part of the loop spent in the scheme
+
+      // I/O only: synthetic iterations instead of the stencil
+      if ( settings.data != "stencil" ) {
+        generate( settings, t, ht.m_TIterations );
+      } else if ( settings.streaming ) {
+        // a single copy of the field: every iteration goes to the scheme after its exchange
+        double begin = MPI_Wtime();
+        io->openStep( t, settings, MPI_COMM_WORLD );
+        writeTime += MPI_Wtime() - begin;
+        for ( unsigned int iter = 1; iter <= settings.iterations; ++iter )
+        {
+          ht.iterate();
+          ht.exchange(MPI_COMM_WORLD);
+          const auto iteration = ht.data_noghost();
+          begin = MPI_Wtime();
+          io->putIteration( iteration, settings, MPI_COMM_WORLD );
+          writeTime += MPI_Wtime() - begin;
+        }
+        begin = MPI_Wtime();
+        io->closeStep( settings, MPI_COMM_WORLD );
+        writeTime += MPI_Wtime() - begin;
+      } else {
+        ht.m_TIterations.clear();
+        for ( unsigned int iter = 1; iter <= settings.iterations; ++iter )
+        {
+          ht.iterate();
+          ht.exchange(MPI_COMM_WORLD);
+          ht.store();
+        }
       }
       //ht.printT("humpa", MPI_COMM_WORLD);
 
       MPI_Barrier(MPI_COMM_WORLD);
-      measTime = MPI_Wtime() - measTime;
+      measTime = MPI_Wtime() - measTime - writeTime;
 
       MPI_Reduce( &measTime, &maxTime, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
       if ( rank == 0 ) {
-        printTime( "Calculation step " + std::to_string( t ), maxTime );
+        printTime( ( settings.data != "stencil" ? "Generating step " : "Calculation step " ) + std::to_string( t ), maxTime );
+        if ( t > settings.warmup ) {
+          computeSample.add( maxTime );
+        }
       }
-
-      MPI_Barrier(MPI_COMM_WORLD);
-      measTime = MPI_Wtime();
-      
-      io.write( t, ht, settings, MPI_COMM_WORLD);
-      
-      MPI_Barrier(MPI_COMM_WORLD);
-      measTime = MPI_Wtime() - measTime;
-
-      MPI_Reduce( &measTime, &maxTime, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
-
-      if ( rank == 0 ) {
-        printPerf( "Writing step " + std::to_string(t), maxTime, settings );
+      results.record( "compute", t, measTime, 0.0 );
+
+      // the candidates write to a scratch name, the step itself follows with the fastest one
+      if ( tuner.tuning() ) {
+        tuner.measure( t,
+          [ &ht, t ]( const Settings& candidate )
+          {
+            Settings trial = candidate;
+            trial.outputfile += ".tune";
+            IO<IOVariant> scratch( trial, MPI_COMM_WORLD );
+            scratch.chooseFormat( trial.format );
+            MPI_Barrier(MPI_COMM_WORLD);
+            double seconds = MPI_Wtime();
+            scratch.write( t, ht, trial, MPI_COMM_WORLD );
+            MPI_Barrier(MPI_COMM_WORLD);
+            seconds = MPI_Wtime() - seconds;
+            scratch.remove( t );
+            return seconds;
+          } );
+        // the fastest candidate of this rung writes the step
+        settings = tuner.choice();
+        io.emplace( settings, MPI_COMM_WORLD );
+        io->chooseFormat( settings.format );
       }
 
-      if ( settings.read ) {
-        IO<IOVariant> istream( settings, MPI_COMM_WORLD );
-        istream.chooseFormat( settings.format );
-        std::vector<std::vector<double> > input( settings.iterations,
-                                                 std::vector<double>( settings.ndx * settings.ndy * settings.ndz, -1.0 ) );
-
+      double rankTime = writeTime; // until this rank is done, without the closing barrier
+      if ( settings.streaming ) {
+        measTime = writeTime;
+      } else {
+        traffic = StorageTraffic::now();
         MPI_Barrier(MPI_COMM_WORLD);
         measTime = MPI_Wtime();
 
-        istream.read( t, input, settings, MPI_COMM_WORLD );
+        io->write( t, ht, settings, MPI_COMM_WORLD);
 
+        rankTime = MPI_Wtime() - measTime;
         MPI_Barrier(MPI_COMM_WORLD);
         measTime = MPI_Wtime() - measTime;
+      }
 
-        checkEquality( input, ht.m_TIterations );
-        peakSignalToNoise( input[0], ht.m_TIterations[0] );
+      MPI_Reduce( &measTime, &maxTime, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
 
-/*
-        std::cout << "input " <<std::endl;
-        for ( auto& vec : input )
-        {
-          for ( auto& val : vec )
-          { std::cout << val << ", ";}
+      const double globalBytes = payloadBytes();
+      if ( rank == 0 ) {
+        if ( globalBytes > 0.0 ) {
+          printPerf( "Writing step " + std::to_string(t), maxTime, settings, ceilings.parallelWrite );
+        } else {
+          printTime( "Writing step " + std::to_string(t), maxTime );
         }
-        std::cout << "\ninput \n" <<std::endl;
-
-        std::cout << "ht.m_TIterations " <<std::endl;
-        for ( auto& vec : ht.m_TIterations )
-        {
-          for ( auto& val : vec )
-          { std::cout << val << ", ";}
+        if ( t > settings.warmup ) {
+          writeSample.add( maxTime );
         }
-        std::cout << "\nht.m_TIteratinos \n" <<std::endl;
-        */
+      }
+      if ( globalBytes > 0.0 ) {
+        printRankRates( "Writing step " + std::to_string(t), rankTime, settings.localGB * 1e9, MPI_COMM_WORLD );
+      }
+      printTraffic( "Storage writing step " + std::to_string(t), traffic, globalBytes, MPI_COMM_WORLD );
+      results.record( "write", t, measTime, globalBytes );
 
-        MPI_Reduce( &measTime, &maxTime, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+      // part of the write time, apart so that schemes compare at equal durability
+      if ( settings.durability != "none" && settings.durability != "close" && settings.stage.empty() ) {
+        const double syncTime = syncSeconds();
+        MPI_Reduce( &syncTime, &maxTime, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
         if ( rank == 0 ) {
-          printPerf( "Reading step " + std::to_string(t), maxTime, settings );
+          printTime( "Syncing step " + std::to_string( t ), maxTime );
         }
+        results.record( "sync", t, syncTime, 0.0 );
+      }
+      if ( settings.phases ) {
+        printPhases( "Writing step " + std::to_string(t), settings.straggler, MPI_COMM_WORLD );
+      }
+
+      if ( auto* stage = io->compression() ) {
+        printCompression( "Compression step " + std::to_string(t), stage->report(), MPI_COMM_WORLD );
+        stage->resetReport();
       }
 
-      if ( settings.remove ) {
+      // shmstage hands its checksums to the consumer with the iterations
+      if ( settings.verify && settings.format != "shmstage" ) {
         MPI_Barrier(MPI_COMM_WORLD);
         measTime = MPI_Wtime();
 
-        io.remove( t );
+        writeChecksums( t, ht.m_TIterations, settings, MPI_COMM_WORLD );
 
-        MPI_Barrier(MPI_COMM_WORLD);
         measTime = MPI_Wtime() - measTime;
-
         MPI_Reduce( &measTime, &maxTime, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
         if ( rank == 0 ) {
-          printTime( "Removing step " + std::to_string( t ), maxTime );
+          printTime( "Checksum step " + std::to_string( t ), maxTime );
         }
       }
     }
 
-    if ( settings.remove ) {
-      RemoveProcFolders( rank );
+    if ( settings.read ) {
+      if ( !settings.readonly ) {
+        io->wait( t );
+      }
+
+      IO<IOVariant> istream( settings, MPI_COMM_WORLD );
+      istream.chooseFormat( settings.format );
+      std::vector<std::vector<double> > input( settings.iterations,
+                                               std::vector<double>( settings.ndx * settings.ndy * settings.ndz, -1.0 ) );
+
+      if ( settings.cold ) {
+        istream.evict( t );
+      }
+
+      traffic = StorageTraffic::now();
+      MPI_Barrier(MPI_COMM_WORLD);
+      measTime = MPI_Wtime();
+
+      istream.read( t, input, settings, MPI_COMM_WORLD );
+
+      const double rankTime = MPI_Wtime() - measTime;
+      MPI_Barrier(MPI_COMM_WORLD);
+      measTime = MPI_Wtime() - measTime;
+
+      // the next step exists already only if it is not written by this run
+      if ( settings.prefetch && settings.readonly && !settings.cold && t < settings.steps ) {
+        istream.prefetch( t + 1 );
+      }
+
+      if ( settings.verify ) {
+        double verifyTime = MPI_Wtime();
+        verifyChecksums( t, input, settings, MPI_COMM_WORLD );
+        verifyTime = MPI_Wtime() - verifyTime;
+        MPI_Reduce( &verifyTime, &maxTime, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+        if ( rank == 0 ) {
+          printTime( "Verifying step " + std::to_string( t ), maxTime );
+        }
+      } else if ( ( !settings.readonly || settings.data != "stencil" ) && settings.format != "mdtest" ) {
+        // synthetic data depends only on the global index, a readonly run regenerates
+        // its own subdomain, which checks steps written with another decomposition
+        if ( settings.readonly ) {
+          generate( settings, t, ht.m_TIterations );
+        }
+        // lossy output is judged by the error reported with the compression
+        if ( settings.lossy == "none" ) {
+          checkEquality( input, ht.m_TIterations );
+        }
+        auto metrics = measureError( ht.m_TIterations, input ).reduce( MPI_COMM_WORLD, 0 );
+        if ( rank == 0 ) {
+          printMetrics( "Validation step " + std::to_string( t ), metrics );
+        }
+      }
+
+/*
+      std::cout << "input " <<std::endl;
+      for ( auto& vec : input )
+      {
+        for ( auto& val : vec )
+        { std::cout << val << ", ";}
+      }
+      std::cout << "\ninput \n" <<std::endl;
+
+      std::cout << "ht.m_TIterations " <<std::endl;
+      for ( auto& vec : ht.m_TIterations )
+      {
+        for ( auto& val : vec )
+        { std::cout << val << ", ";}
+      }
+      std::cout << "\nht.m_TIteratinos \n" <<std::endl;
+      */
+
+      const double globalBytes = payloadBytes();
+      MPI_Reduce( &measTime, &maxTime, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+      if ( rank == 0 ) {
+        if ( globalBytes > 0.0 ) {
+          printPerf( "Reading step " + std::to_string(t), maxTime, settings, ceilings.parallelRead );
+        } else {
+          printTime( "Reading step " + std::to_string(t), maxTime );
+        }
+        if ( t > settings.warmup ) {
+          readSample.add( maxTime );
+        }
+      }
+      if ( globalBytes > 0.0 ) {
+        printRankRates( "Reading step " + std::to_string(t), rankTime, settings.localGB * 1e9, MPI_COMM_WORLD );
+      }
+      printTraffic( "Storage reading step " + std::to_string(t), traffic, globalBytes, MPI_COMM_WORLD );
+      results.record( "read", t, measTime, globalBytes );
+      if ( settings.phases ) {
+        printPhases( "Reading step " + std::to_string(t), settings.straggler, MPI_COMM_WORLD );
+      }
+
+      if ( auto* stage = istream.compression() ) {
+        printCompression( "Decompression step " + std::to_string(t), stage->report(), MPI_COMM_WORLD );
+      }
+    }
+
+    // rotation: the step falling out of the last keep steps
+    if ( settings.remove && t > settings.keep ) {
+      const unsigned int victim = t - settings.keep;
+      traffic = StorageTraffic::now();
+      MPI_Barrier(MPI_COMM_WORLD);
+      measTime = MPI_Wtime();
+
+      io->remove( victim );
+      if ( settings.verify ) {
+        removeChecksums( victim, settings, MPI_COMM_WORLD );
+      }
+
+      MPI_Barrier(MPI_COMM_WORLD);
+      measTime = MPI_Wtime() - measTime;
+
+      MPI_Reduce( &measTime, &maxTime, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+      if ( rank == 0 ) {
+        printTime( "Removing step " + std::to_string( victim ), maxTime );
+      }
+      printTraffic( "Storage removing step " + std::to_string( victim ), traffic, 0.0, MPI_COMM_WORLD );
+      results.record( "remove", victim, measTime, 0.0 );
+    }
+
+    printMemory( "Memory step " + std::to_string(t), ht.heldBytes(), io->heldBytes(), MPI_COMM_WORLD );
+
+    // stopping rule: one more step while a measured phase is not within ci of its mean
+    if ( t == lastStep && settings.ci > 0.0 && lastStep < settings.maxSteps ) {
+      int more = 0;
+      if ( rank == 0 ) {
+        for ( const Sample* sample : { &computeSample, &writeSample, &readSample } ) {
+          if ( sample->count() > 0 && !sample->converged( settings.ci ) ) {
+            more = 1;
+          }
+        }
+      }
+      MPI_Bcast( &more, 1, MPI_INT, 0, MPI_COMM_WORLD );
+      lastStep += static_cast<unsigned int>( more );
+    }
+  }
+
+  if ( rank == 0 ) {
+    const double stepBytes = payloadBytes();
+    printStatistics( settings.data != "stencil" ? "Statistics generate" : "Statistics compute", computeSample, 0.0 );
+    printStatistics( "Statistics write", writeSample, stepBytes );
+    printStatistics( "Statistics read", readSample, stepBytes );
+    if ( settings.ci > 0.0 && lastStep == settings.maxSteps ) {
+      for ( const Sample* sample : { &computeSample, &writeSample, &readSample } ) {
+        if ( sample->count() > 0 && !sample->converged( settings.ci ) ) {
+          std::cout << "WARNING: maxsteps reached before the confidence intervals were within ci\n";
+          break;
+        }
+      }
+    }
+  }
+
+  if ( !settings.stage.empty() && !settings.readonly ) {
+    MPI_Barrier(MPI_COMM_WORLD);
+    measTime = MPI_Wtime();
+
+    io->wait( lastStep );
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    measTime = MPI_Wtime() - measTime;
+
+    MPI_Reduce( &measTime, &maxTime, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+    if ( rank == 0 ) {
+      printTime( "Draining remaining steps", maxTime );
     }
-    
+  }
+
+  if ( settings.remove ) {
     MPI_Barrier(MPI_COMM_WORLD);
-    totalTime = MPI_Wtime() - totalTime;
+    measTime = MPI_Wtime();
+
+    auto removal = io->flushRemovals();
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    measTime = MPI_Wtime() - measTime;
+
+    double files = 0.0, maxBusy = 0.0, maxLag = 0.0;
+    MPI_Reduce( &measTime, &maxTime, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+    MPI_Reduce( &removal.files, &files, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Reduce( &removal.busy, &maxBusy, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+    MPI_Reduce( &removal.maxLag, &maxLag, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+    if ( rank == 0 && ( settings.keep > 0 || settings.asyncRemove ) ) {
+      printTime( "Removing pending steps", maxTime );
+      std::cout << "Removal service files " << files
+                << " max. busy time [s] " << maxBusy
+                << " max. lag [s] " << maxLag << "\n";
+    }
+
+    // the folders still hold the kept steps
+    if ( settings.keep == 0 ) {
+      RemoveProcFolders( rank, settings.layout, MPI_COMM_WORLD );
+    }
+  }
+  
+  MPI_Barrier(MPI_COMM_WORLD);
+  totalTime = MPI_Wtime() - totalTime;
+
+  MPI_Reduce( &totalTime, &maxTime, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+  const double peak = PeakResidentBytes();
+  double maxPeak = 0.0;
+  MPI_Reduce( &peak, &maxPeak, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+  if ( rank == 0 ) {
+    std::cout << "Peak RSS max. [MiB] " << maxPeak / ( 1024.0 * 1024.0 ) << "\n";
+  }
+  if ( settings.counters ) {
+    counters::print( MPI_COMM_WORLD );
+    counters::enabled = false;
+  }
+  if (rank == 0) {
+    std::cout << "Total runtime = " << maxTime << "s\n";
+    results.summary( maxTime, lastStep );
+  }
+  return samples;
+}
+
+
+int main( int argc, char* argv[] ) {
+  
+  // the drain thread of stage= calls MPI concurrently with the solver
+  bool staged = std::any_of( argv + std::min( argc, 12 ), argv + argc,
+                             []( const char* arg ) { return std::string_view( arg ).starts_with( "stage=" ); } );
+  int provided;
+  MPI_Init_thread( &argc, &argv, staged ? MPI_THREAD_MULTIPLE : MPI_THREAD_SINGLE, &provided );
+  
+  int rank, nproc;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank );
+  MPI_Comm_size(MPI_COMM_WORLD, &nproc );
 
-    MPI_Reduce( &totalTime, &maxTime, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
-    if (rank == 0) {
-      std::cout << "Total runtime = " << maxTime << "s\n";
+  try
+  {
+    Settings settings( argc, argv, rank, nproc );
+    const auto runs = sweepRuns( settings );
+    if ( !settings.trace.empty() ) {
+      trace::start( MPI_COMM_WORLD );
+    }
+    // once per job, the runs of a sweep share the output directory
+    const Ceilings ceilings = settings.calibrate ? calibrate( settings, MPI_COMM_WORLD ) : Ceilings{};
+    // the steps of all rounds of a configuration, rank 0 only
+    std::vector<Samples> pooled;
+    std::vector<const Run*> configurations;
+    for ( const auto& r : runs ) {
+      if ( r.configuration >= configurations.size() ) {
+        pooled.resize( r.configuration + 1 );
+        configurations.resize( r.configuration + 1, nullptr );
+      }
+      configurations[r.configuration] = &r;
+    }
+    for ( const auto& r : runs ) {
+      if ( runs.size() > 1 && rank == 0 ) {
+        std::cout << "Configuration " << r.settings.run + 1 << "/" << runs.size()
+                  << " scheme " << r.settings.format
+                  << " local " << r.settings.ndx << "x" << r.settings.ndy << "x" << r.settings.ndz
+                  << " iterations " << r.settings.iterations
+                  << " hints " << toString( r.settings.hints )
+                  << " round " << r.round + 1 << "\n";
+      }
+      const Samples samples = run( r.settings, ceilings, rank );
+      pooled[r.configuration].compute.add( samples.compute );
+      pooled[r.configuration].write.add( samples.write );
+      pooled[r.configuration].read.add( samples.read );
+    }
+    if ( settings.sweepRounds > 1 && rank == 0 ) {
+      for ( std::size_t c = 0; c < configurations.size(); ++c ) {
+        const Settings& s = configurations[c]->settings;
+        const double stepBytes = s.format == "mdtest" ? 0.0 : s.globalGB * 1e9;
+        const std::string configuration = " scheme " + s.format
+                                        + " local " + std::to_string( s.ndx ) + "x" + std::to_string( s.ndy ) + "x" + std::to_string( s.ndz )
+                                        + " iterations " + std::to_string( s.iterations ) + " hints " + toString( s.hints )
+                                        + " rounds " + std::to_string( settings.sweepRounds );
+        printStatistics( ( s.data != "stencil" ? "Pooled statistics generate" : "Pooled statistics compute" ) + configuration,
+                         pooled[c].compute, 0.0 );
+        printStatistics( "Pooled statistics write" + configuration, pooled[c].write, stepBytes );
+        printStatistics( "Pooled statistics read" + configuration, pooled[c].read, stepBytes );
+      }
+    }
+    if ( !settings.trace.empty() ) {
+      trace::write( settings.trace, MPI_COMM_WORLD );
     }
   }
   catch ( std::invalid_argument& e ) // command-line argument errors